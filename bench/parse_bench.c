@@ -0,0 +1,155 @@
+/**
+ * Compares the text number parsers in pgtypes.c with the libc functions the
+ * getters used before (strtol/strtoll/strtod).
+ *
+ * Each workload is a text-format PGresult column built in memory with a
+ * distribution typical of real tables, so no server is needed:
+ * - int4 ids:     sequential primary keys up to 10^7
+ * - int8 keys:    random 63-bit values (snowflake-style ids)
+ * - int4 counts:  small signed values
+ * - float8 money: amounts with two decimals
+ * - float8 ratio: random doubles in [0, 1) in shortest round-trip form
+ *                 (PostgreSQL 12+ output, up to 17 digits)
+ * - float8 sci:   measurements printed with an exponent
+ *
+ * Both paths must decode identical values; the benchmark aborts otherwise.
+ *
+ * Usage: ./parse_bench [rows] [passes]
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "pgtypes.h"
+
+typedef enum { INT4_IDS, INT8_KEYS, INT4_COUNTS, FLOAT8_MONEY, FLOAT8_RATIO, FLOAT8_SCI } workload_t;
+
+static const char* NAMES[] = {"int4 ids", "int8 keys", "int4 counts", "float8 money", "float8 ratio", "float8 sci"};
+
+static double now_ms(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec * 1e3 + (double)ts.tv_nsec / 1e6;
+}
+
+static uint64_t rng_state = 0x9E3779B97F4A7C15ULL;
+
+/** xorshift64: cheap, reproducible input. */
+static uint64_t next_random(void) {
+    rng_state ^= rng_state << 13;
+    rng_state ^= rng_state >> 7;
+    rng_state ^= rng_state << 17;
+    return rng_state;
+}
+
+/** Formats one value of the workload into buf and returns its length. */
+static int format_value(workload_t w, int row, char* buf, size_t size) {
+    switch (w) {
+        case INT4_IDS:
+            return snprintf(buf, size, "%d", 1 + row % 10000000);
+        case INT8_KEYS:
+            return snprintf(buf, size, "%lld", (long long)(next_random() >> 1));
+        case INT4_COUNTS:
+            return snprintf(buf, size, "%d", (int)(next_random() % 2001) - 1000);
+        case FLOAT8_MONEY:
+            return snprintf(buf, size, "%llu.%02llu", (unsigned long long)(next_random() % 100000),
+                            (unsigned long long)(next_random() % 100));
+        case FLOAT8_RATIO: {
+            double d = (double)(next_random() >> 11) / (double)(1ULL << 53);
+            int len  = 0;
+            for (int precision = 15; precision <= 17; precision++) {
+                len = snprintf(buf, size, "%.*g", precision, d);
+                if (strtod(buf, NULL) == d) break;
+            }
+            return len;
+        }
+        case FLOAT8_SCI:
+            return snprintf(buf, size, "%.6e", (double)(next_random() % 1000000) * 1e-9);
+    }
+    return 0;
+}
+
+static PGresult* make_column(workload_t w, int rows) {
+    PGresult* res     = PQmakeEmptyPGresult(NULL, PGRES_TUPLES_OK);
+    bool is_float     = w >= FLOAT8_MONEY;
+    PGresAttDesc attr = {"v", 0, 0, 0, is_float ? PG_OID_FLOAT8 : PG_OID_INT8, 8, -1};
+
+    if (!res || !PQsetResultAttrs(res, 1, &attr)) {
+        fprintf(stderr, "Failed to build result\n");
+        exit(1);
+    }
+
+    char buf[64];
+    for (int i = 0; i < rows; i++) {
+        int len = format_value(w, i, buf, sizeof(buf));
+        if (!PQsetvalue(res, i, 0, buf, len)) {
+            fprintf(stderr, "Failed to build result\n");
+            exit(1);
+        }
+    }
+    return res;
+}
+
+/** Sum of all values through libc, with the same per-cell checks as the getters before. */
+static double sum_libc(PGresult* res, bool is_float) {
+    double sum = 0;
+    int rows   = PQntuples(res);
+    for (int i = 0; i < rows; i++) {
+        if (PQfformat(res, 0) == 1 || PQgetisnull(res, i, 0)) continue;
+
+        char* end;
+        sum += is_float ? strtod(PQgetvalue(res, i, 0), &end) : (double)strtoll(PQgetvalue(res, i, 0), &end, 10);
+    }
+    return sum;
+}
+
+/** Sum of all values through the pgtypes getters. */
+static double sum_getters(PGresult* res, bool is_float) {
+    double sum = 0;
+    int rows   = PQntuples(res);
+    for (int i = 0; i < rows; i++) {
+        sum += is_float ? pg_get_double(res, i, 0, NULL) : (double)pg_get_longlong(res, i, 0, NULL);
+    }
+    return sum;
+}
+
+/** Runs fn `passes` times and returns the best time per value in ns. */
+static double time_ns(double (*fn)(PGresult*, bool), PGresult* res, bool is_float, int passes, double* sum) {
+    double best = 1e300;
+    for (int p = 0; p < passes; p++) {
+        double start = now_ms();
+        *sum         = fn(res, is_float);
+        double ms    = now_ms() - start;
+        if (ms < best) best = ms;
+    }
+    return best * 1e6 / PQntuples(res);
+}
+
+int main(int argc, char** argv) {
+    int rows   = argc > 1 ? atoi(argv[1]) : 1000000;
+    int passes = argc > 2 ? atoi(argv[2]) : 5;
+
+    printf("%d rows, best of %d passes\n", rows, passes);
+    printf("%-14s %12s %12s %8s\n", "workload", "libc ns/val", "pgtypes ns", "speedup");
+
+    for (workload_t w = INT4_IDS; w <= FLOAT8_SCI; w++) {
+        PGresult* res = make_column(w, rows);
+        bool is_float = w >= FLOAT8_MONEY;
+
+        double libc_sum = 0, fast_sum = 0;
+        double libc_ns = time_ns(sum_libc, res, is_float, passes, &libc_sum);
+        double fast_ns = time_ns(sum_getters, res, is_float, passes, &fast_sum);
+
+        if (libc_sum != fast_sum) {
+            fprintf(stderr, "%s: results differ (%.17g vs %.17g)\n", NAMES[w], libc_sum, fast_sum);
+            return 1;
+        }
+
+        printf("%-14s %12.1f %12.1f %7.2fx\n", NAMES[w], libc_ns, fast_ns, libc_ns / fast_ns);
+        PQclear(res);
+    }
+
+    return 0;
+}
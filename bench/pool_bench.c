@@ -0,0 +1,139 @@
+/**
+ * Microbenchmark: checkout/checkin cost of pgconn_pool_t versus a pool
+ * guarded by a single mutex (the design pgconn_pool_t replaced).
+ *
+ * Each thread repeatedly acquires and releases a connection without running a
+ * query, so the numbers isolate pool overhead.
+ *
+ * Usage: POSTGRES_URI=... ./pool_bench [threads] [iterations] [pool_size]
+ */
+
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#include "pgpool.h"
+
+/** Baseline: idle stack protected by one mutex, condition variable when empty. */
+typedef struct {
+    pthread_mutex_t lock;
+    pthread_cond_t available;
+    pgconn_t** idle;
+    size_t idle_count;
+} mutex_pool_t;
+
+static pgconn_t* mutex_pool_acquire(mutex_pool_t* pool) {
+    pthread_mutex_lock(&pool->lock);
+    while (pool->idle_count == 0) {
+        pthread_cond_wait(&pool->available, &pool->lock);
+    }
+    pgconn_t* conn = pool->idle[--pool->idle_count];
+    pthread_mutex_unlock(&pool->lock);
+    return conn;
+}
+
+static void mutex_pool_release(mutex_pool_t* pool, pgconn_t* conn) {
+    pthread_mutex_lock(&pool->lock);
+    pool->idle[pool->idle_count++] = conn;
+    pthread_cond_signal(&pool->available);
+    pthread_mutex_unlock(&pool->lock);
+}
+
+typedef struct {
+    pgconn_pool_t* pool;
+    mutex_pool_t* mutex_pool;
+    long iterations;
+} bench_args_t;
+
+static void* lockfree_worker(void* arg) {
+    bench_args_t* args = arg;
+    for (long i = 0; i < args->iterations; i++) {
+        pgconn_t* conn = pgconn_pool_acquire(args->pool, -1);
+        pgconn_pool_release(args->pool, conn);
+    }
+    return NULL;
+}
+
+static void* mutex_worker(void* arg) {
+    bench_args_t* args = arg;
+    for (long i = 0; i < args->iterations; i++) {
+        pgconn_t* conn = mutex_pool_acquire(args->mutex_pool);
+        mutex_pool_release(args->mutex_pool, conn);
+    }
+    return NULL;
+}
+
+static double now_sec(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec / 1e9;
+}
+
+/** Runs `worker` on n_threads threads and prints ns per acquire+release pair. */
+static void run(const char* name, void* (*worker)(void*), bench_args_t* args, int n_threads) {
+    pthread_t* threads = calloc((size_t)n_threads, sizeof(pthread_t));
+
+    double start = now_sec();
+    for (int i = 0; i < n_threads; i++) {
+        pthread_create(&threads[i], NULL, worker, args);
+    }
+    for (int i = 0; i < n_threads; i++) {
+        pthread_join(threads[i], NULL);
+    }
+    double elapsed = now_sec() - start;
+
+    double ops = (double)args->iterations * n_threads;
+    printf("%-10s threads=%-3d %8.1f ns/op  %12.0f ops/s\n", name, n_threads, elapsed * 1e9 / ops, ops / elapsed);
+    free(threads);
+}
+
+int main(int argc, char** argv) {
+    const char* conninfo = getenv("POSTGRES_URI");
+    if (!conninfo) {
+        fprintf(stderr, "POSTGRES_URI environment variable not set\n");
+        return 1;
+    }
+
+    int max_threads  = argc > 1 ? atoi(argv[1]) : 32;
+    long iterations  = argc > 2 ? atol(argv[2]) : 1000000;
+    size_t pool_size = argc > 3 ? (size_t)atol(argv[3]) : 8;
+
+    pgconn_pool_config_t config = {
+        .conn_config = {.conninfo = conninfo},
+        .min_size    = pool_size,
+        .max_size    = pool_size,
+    };
+
+    pgconn_pool_t* pool = pgconn_pool_create(&config);
+    if (!pool) {
+        return 1;
+    }
+
+    // The baseline borrows the same connections so both sides do identical work
+    mutex_pool_t mutex_pool = {.idle = calloc(pool_size, sizeof(pgconn_t*))};
+    pthread_mutex_init(&mutex_pool.lock, NULL);
+    pthread_cond_init(&mutex_pool.available, NULL);
+    for (size_t i = 0; i < pool_size; i++) {
+        mutex_pool.idle[mutex_pool.idle_count++] = pgconn_pool_acquire(pool, -1);
+    }
+
+    bench_args_t args = {.pool = pool, .mutex_pool = &mutex_pool, .iterations = iterations};
+    for (int n = 1; n <= max_threads; n *= 2) {
+        run("mutex", mutex_worker, &args, n);
+    }
+
+    for (size_t i = 0; i < pool_size; i++) {
+        pgconn_pool_release(pool, mutex_pool.idle[i]);
+    }
+
+    for (int n = 1; n <= max_threads; n *= 2) {
+        run("lock-free", lockfree_worker, &args, n);
+    }
+
+    pthread_cond_destroy(&mutex_pool.available);
+    pthread_mutex_destroy(&mutex_pool.lock);
+    free(mutex_pool.idle);
+    pgconn_pool_destroy(pool);
+    return 0;
+}
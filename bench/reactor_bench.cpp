@@ -0,0 +1,127 @@
+/**
+ * Compares the epoll and io_uring reactors of the coroutine layer.
+ *
+ * Every connection of a pool runs a coroutine that sends `queries` short
+ * queries back to back, all driven by a single reactor thread. The benchmark
+ * reports throughput and the event-loop system calls per query (epoll_wait and
+ * epoll_ctl versus io_uring_enter); the recv/send calls libpq makes are the
+ * same for both and are not counted.
+ *
+ * A second pass sends fewer queries whose single value is LARGE_RESULT bytes,
+ * so each result arrives over many socket reads and a reactor that misses
+ * readiness for bytes already queued stalls instead of finishing.
+ *
+ * Usage: POSTGRES_URI=... ./reactor_bench [connections] [queries]
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#include "pgconn_uring.hpp"
+
+#define LARGE_RESULT 400000
+#define LARGE_RESULT_SQL "SELECT repeat('x', 400000)"
+
+static double now_ms() {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec * 1e3 + (double)ts.tv_nsec / 1e6;
+}
+
+struct run_state {
+    int remaining;  // Coroutines still running
+    long failed;    // Queries that returned no result or a truncated one
+};
+
+static pgconn_coro::task<void> worker(pgconn_coro::pool& db, pgconn_coro::reactor& r, run_state& state,
+                                      int queries, bool large) {
+    pgconn_coro::connection conn = co_await db.acquire(r);
+    if (!conn) {
+        state.failed += queries;
+    }
+
+    for (int i = 0; conn && i < queries; i++) {
+        if (large) {
+            pgconn_coro::result res = co_await conn.query(LARGE_RESULT_SQL);
+            if (!res || PQntuples(res.get()) != 1 || PQgetlength(res.get(), 0, 0) != LARGE_RESULT) {
+                state.failed++;
+            }
+        } else {
+            pgconn_coro::result res = co_await conn.query("SELECT $1::int", "1");
+            if (!res) {
+                state.failed++;
+            }
+        }
+    }
+
+    if (--state.remaining == 0) {
+        r.stop();
+    }
+}
+
+static void run(const char* name, pgconn_coro::reactor& r, pgconn_coro::pool& db, int connections, int queries,
+                bool large) {
+    run_state state = {connections, 0};
+
+    for (int i = 0; i < connections; i++) {
+        pgconn_coro::spawn(r, worker(db, r, state, queries, large));
+    }
+
+    double start = now_ms();
+    r.run();
+    double elapsed = now_ms() - start;
+
+    double total = (double)connections * queries;
+    printf("%-8s %10.0f queries/s %8.3f syscalls/query %6ld failed\n",
+           name,
+           total / (elapsed / 1e3),
+           (double)r.syscall_count() / total,
+           state.failed);
+}
+
+int main(int argc, char** argv) {
+    const char* conninfo = getenv("POSTGRES_URI");
+    if (!conninfo) {
+        fprintf(stderr, "Set POSTGRES_URI to run the benchmark\n");
+        return 1;
+    }
+
+    int connections = argc > 1 ? atoi(argv[1]) : 64;
+    int queries     = argc > 2 ? atoi(argv[2]) : 2000;
+
+    pgconn_pool_config_t config = {};
+    config.conn_config.conninfo = conninfo;
+    config.min_size             = (size_t)connections;
+    config.max_size             = (size_t)connections;
+
+    pgconn_pool_t* pool = pgconn_pool_create(&config);
+    if (!pool) {
+        return 1;
+    }
+    pgconn_coro::pool db(pool);
+
+    printf("%d connections x %d queries, one reactor thread\n", connections, queries);
+    {
+        pgconn_coro::epoll_reactor r;
+        run("epoll", r, db, connections, queries, false);
+    }
+    {
+        pgconn_coro::uring_reactor r;
+        run("io_uring", r, db, connections, queries, false);
+    }
+
+    int large_queries = queries / 100 > 0 ? queries / 100 : 1;
+    printf("%d connections x %d queries returning %d bytes\n", connections, large_queries, LARGE_RESULT);
+    {
+        pgconn_coro::epoll_reactor r;
+        run("epoll", r, db, connections, large_queries, true);
+    }
+    {
+        pgconn_coro::uring_reactor r;
+        run("io_uring", r, db, connections, large_queries, true);
+    }
+
+    pgconn_pool_destroy(pool);
+    return 0;
+}
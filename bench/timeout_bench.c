@@ -0,0 +1,103 @@
+/**
+ * Measures how far query timeouts overshoot their limit.
+ *
+ * Two workloads are run against each timeout:
+ * - silent:  a single long pg_sleep(); the server sends nothing until it ends.
+ * - trickle: a loop that raises a NOTICE every 10 ms, so the socket keeps
+ *            waking the client up before the timeout expires.
+ *
+ * With a per-wakeup timeout, the trickle workload overshoots by roughly the
+ * whole query duration; with an absolute deadline both stay within a few ms.
+ *
+ * Usage: POSTGRES_URI=... ./timeout_bench [runs]
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#include "pgconn.h"
+
+static const char* SILENT_SQL = "SELECT pg_sleep(5)";
+
+static const char* TRICKLE_SQL =
+    "DO $$ BEGIN "
+    "FOR i IN 1..500 LOOP RAISE NOTICE 'tick %', i; PERFORM pg_sleep(0.01); END LOOP; "
+    "END $$";
+
+static double now_ms(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec * 1e3 + (double)ts.tv_nsec / 1e6;
+}
+
+/** Silences the NOTICE flood of the trickle workload. */
+static void ignore_notice(void* arg, const char* message) {
+    (void)arg;
+    (void)message;
+}
+
+static void init_connection(PGconn* raw) {
+    PQsetNoticeProcessor(raw, ignore_notice, NULL);
+}
+
+/** Runs `sql` with `timeout_ms` several times and prints the overshoot. */
+static void run(pgconn_t* conn, const char* name, const char* sql, int timeout_ms, int runs) {
+    pgconn_query_opts_t opts = {.timeout_ms = timeout_ms};
+    double min = 1e12, max = 0, sum = 0;
+    int timed_out = 0;
+
+    for (int i = 0; i < runs; i++) {
+        double start = now_ms();
+        bool ok      = pgconn_execute(conn, sql, &opts);
+        double over  = now_ms() - start - timeout_ms;
+
+        if (!ok) {
+            timed_out++;
+        }
+        if (over < min) min = over;
+        if (over > max) max = over;
+        sum += over;
+
+        // A cancelled query may leave the connection unusable; start fresh
+        if (pgconn_status(conn) != CONNECTION_OK && !pgconn_reconnect(conn)) {
+            fprintf(stderr, "Reconnect failed: %s\n", pgconn_error_message(conn));
+            exit(1);
+        }
+    }
+
+    printf("%-8s timeout=%5d ms  timed out %d/%d  overshoot min %7.2f  avg %7.2f  max %7.2f ms\n",
+           name,
+           timeout_ms,
+           timed_out,
+           runs,
+           min,
+           sum / runs,
+           max);
+}
+
+int main(int argc, char** argv) {
+    const char* conninfo = getenv("POSTGRES_URI");
+    if (!conninfo) {
+        fprintf(stderr, "POSTGRES_URI environment variable not set\n");
+        return 1;
+    }
+
+    int runs = argc > 1 ? atoi(argv[1]) : 10;
+    if (runs < 1) runs = 1;
+
+    pgconn_config_t config = {.conninfo = conninfo, .connection_init = init_connection};
+    pgconn_t* conn         = pgconn_create(&config);
+    if (!conn) {
+        return 1;
+    }
+
+    static const int timeouts[] = {10, 50, 100, 500, 1000};
+    for (size_t i = 0; i < sizeof(timeouts) / sizeof(timeouts[0]); i++) {
+        run(conn, "silent", SILENT_SQL, timeouts[i], runs);
+        run(conn, "trickle", TRICKLE_SQL, timeouts[i], runs);
+    }
+
+    pgconn_destroy(conn);
+    return 0;
+}
@@ -2,47 +2,56 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <unistd.h>
-#include "pgconn.h"
+#include "pgpool.h"
 
 #define THREAD_COUNT 4
 #define ITERATIONS   5
 
 typedef struct {
-    pgconn_t* conn;
+    pgconn_pool_t* pool;
     int thread_id;
 } thread_data_t;
 
 void* thread_func(void* arg) {
     thread_data_t* data = (thread_data_t*)arg;
-    pgconn_t* conn      = data->conn;
+    pgconn_pool_t* pool = data->pool;
     int thread_id       = data->thread_id;
 
     for (int i = 0; i < ITERATIONS; i++) {
         printf("Thread %d, iteration %d\n", thread_id, i);
 
+        // Check out a connection for exclusive use by this thread
+        pgconn_t* conn = pgconn_pool_acquire(pool, 5000);
+        if (!conn) {
+            fprintf(stderr, "Thread %d acquire failed: %s\n", thread_id, pgconn_pool_error_message(pool));
+            continue;
+        }
+
         // Execute a simple query
-        PGresult* res = pgconn_query_safe(conn, "SELECT 1", NULL);
+        PGresult* res = pgconn_query(conn, "SELECT 1", NULL);
         if (res) {
             PQclear(res);
         } else {
-            fprintf(stderr, "Thread %d query failed: %s\n", thread_id, pgconn_error_message_safe(conn));
+            fprintf(stderr, "Thread %d query failed: %s\n", thread_id, pgconn_error_message(conn));
         }
 
         // Execute a prepared statement
-        if (pgconn_prepare_safe(conn, "get_user", "SELECT * FROM users WHERE id = $1", 1, NULL)) {
+        if (pgconn_prepare(conn, "get_user", "SELECT * FROM users WHERE id = $1", 1, NULL)) {
             const char* params[] = {"1"};
-            res                  = pgconn_execute_prepared_safe(conn, "get_user", 1, params, NULL);
+            res                  = pgconn_execute_prepared(conn, "get_user", 1, params, NULL);
             if (res) {
                 PQclear(res);
             } else {
                 const char* fmt = "Thread %d prepared statement failed: %s\n";
-                fprintf(stderr, fmt, thread_id, pgconn_error_message_safe(conn));
+                fprintf(stderr, fmt, thread_id, pgconn_error_message(conn));
             }
-            pgconn_deallocate_safe(conn, "get_user");
+            pgconn_deallocate(conn, "get_user");
         } else {
-            fprintf(stderr, "Thread %d prepare failed: %s\n", thread_id, pgconn_error_message_safe(conn));
+            fprintf(stderr, "Thread %d prepare failed: %s\n", thread_id, pgconn_error_message(conn));
         }
 
+        pgconn_pool_release(pool, conn);
+
         // Small delay to simulate think time
         usleep((unsigned)(10000 * (1 + (rand() % 5))));
     }
@@ -57,14 +66,18 @@ int main() {
         return 1;
     }
 
-    pgconn_config_t config = {
-        .conninfo       = conninfo,
-        .auto_reconnect = true,
-        .thread_safe    = true,
+    pgconn_pool_config_t config = {
+        .conn_config =
+            {
+                .conninfo       = conninfo,
+                .auto_reconnect = true,
+            },
+        .min_size = 2,
+        .max_size = THREAD_COUNT,
     };
 
-    pgconn_t* conn = pgconn_create(&config);
-    if (!conn) {
+    pgconn_pool_t* pool = pgconn_pool_create(&config);
+    if (!pool) {
         return 1;
     }
 
@@ -73,12 +86,12 @@ int main() {
 
     // Create threads
     for (int i = 0; i < THREAD_COUNT; i++) {
-        thread_data[i].conn      = conn;
+        thread_data[i].pool      = pool;
         thread_data[i].thread_id = i;
 
         if (pthread_create(&threads[i], NULL, thread_func, &thread_data[i]) != 0) {
             perror("Failed to create thread");
-            pgconn_destroy(conn);
+            pgconn_pool_destroy(pool);
             return 1;
         }
     }
@@ -88,6 +101,6 @@ int main() {
         pthread_join(threads[i], NULL);
     }
 
-    pgconn_destroy(conn);
+    pgconn_pool_destroy(pool);
     return 0;
 }
@@ -1,15 +1,48 @@
 #include "pgconn.h"
+#include "pgconn_internal.h"
 
 #include <errno.h>
+#include <limits.h>
+#include <poll.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
-#include <sys/select.h>
-#include <sys/time.h>
+#include <time.h>
 
 // Error message buffer capacity
 #define PGCONN_ERR_CAPACITY 512
 
+// COPY data is sent to the server once this much has been buffered
+#define PGCONN_COPY_FLUSH_SIZE (64 * 1024)
+
+// How long a cancelled query may take to finish before its connection is closed
+#define PGCONN_CANCEL_DRAIN_MS 5000
+
+// Default capacity of the prepared-statement cache
+#define PGCONN_STMT_CACHE_SIZE 64
+
+// How long the SELECT 1 of a validation may take before the connection counts as broken
+#define PGCONN_VALIDATE_TIMEOUT_MS 5000
+
+/** Statement prepared through pgconn_prepare(), kept so it can be re-prepared after a reconnect. */
+typedef struct prepared_entry {
+    char* name;                   // Statement name (owned)
+    char* query;                  // Query text (owned)
+    int n_params;                 // Number of entries in param_types
+    Oid* param_types;             // Parameter types (owned, NULL = inferred)
+    struct prepared_entry* next;  // Next registered statement
+} prepared_entry_t;
+
+/** Prepared statement owned by the statement cache. */
+typedef struct stmt_entry {
+    uint64_t hash;                   // FNV-1a hash of sql
+    char* sql;                       // Query text (owned)
+    char name[32];                   // Generated server-side statement name
+    struct stmt_entry* bucket_next;  // Next entry in the same hash bucket
+    struct stmt_entry* lru_prev;     // More recently used neighbour
+    struct stmt_entry* lru_next;     // Less recently used neighbour
+} stmt_entry_t;
+
 // Global connection ID counter (atomic-like increment under mutex during creation)
 static uint32_t g_next_conn_id = 1;
 
@@ -18,12 +51,51 @@ struct pgconn {
     PGconn* raw_conn;                      // Underlying libpq connection
     pthread_mutex_t lock;                  // Mutex for thread-safe operations
     char last_error[PGCONN_ERR_CAPACITY];  // Last error message
+    char last_sqlstate[6];                 // SQLSTATE of the last server error ("" if none)
+    bool timed_out;                        // Last error was a query timeout
     uint32_t connection_id;                // Unique connection identifier
     time_t last_activity;                  // Last query execution time
+    time_t created_at;                     // When the current session was established
     int reconnect_attempts;                // Current reconnection attempts
     bool thread_safe;                      // Whether thread-safety is enabled
     bool transaction_active;               // Transaction state flag
+    int pipeline_queued;                   // Pipelined queries whose results are unread
+    int pipeline_syncs;                    // Sync points sent but not yet reached
+    bool copy_in_active;                   // Inside COPY FROM STDIN
+    pgconn_copy_format_t copy_format;      // Row encoding of the active COPY
+    int op_timeout_ms;                     // timeout_ms of the active COPY or stream
+    char* copy_buf;                        // Encoded COPY data not yet sent
+    size_t copy_len;                       // Bytes used in copy_buf
+    size_t copy_cap;                       // Capacity of copy_buf
+    bool copy_out_active;                  // Inside COPY TO STDOUT
+    bool copy_out_done;                    // COPY TO STDOUT finished and its result was read
+    bool copy_out_header;                  // Binary COPY header not yet parsed
+    char* copy_chunk;                      // Last chunk from PQgetCopyData (freed on next read)
+    const char** copy_values;              // Decoded binary COPY fields
+    int* copy_lengths;                     // Decoded binary COPY field lengths
+    int copy_fields_cap;                   // Capacity of copy_values/copy_lengths
+    bool stream_active;                    // Inside a streaming query
+    bool stream_done;                      // Streaming query fully read
+    stmt_entry_t** stmt_buckets;           // Statement cache hash table
+    size_t stmt_bucket_mask;               // Bucket count - 1 (power of two)
+    stmt_entry_t* stmt_lru_head;           // Most recently used cached statement
+    stmt_entry_t* stmt_lru_tail;           // Least recently used cached statement
+    int stmt_count;                        // Cached statements
+    uint64_t stmt_seq;                     // Source of generated statement names
+    prepared_entry_t* prepared;            // Statements to restore after a reconnect
+    bool reprepare_pending;                // Reconnected, registered statements not yet restored
+    bool async_active;                     // Asynchronous query in flight
+    PGresult* async_result;                // Result collected so far / awaiting pgconn_async_result()
+    pgconn_result_fn async_fn;             // Completion callback of the asynchronous query
+    void* async_user_data;                 // User data for async_fn
+    bool connecting;                       // Non-blocking connection attempt in progress
+    PostgresPollingStatusType connect_state;  // Last PQconnectPoll() result
+    bool connect_deadline_set;             // connect_timeout applies to the attempt
+    struct timespec connect_deadline;      // CLOCK_MONOTONIC end of the attempt
+    bool backoff_set;                      // A failed reconnect scheduled the next attempt
+    struct timespec backoff_until;         // CLOCK_MONOTONIC time the next attempt may start
     pgconn_config_t config;                // Configuration (with copied strings)
+    void* pool_slot;                       // Owning pool slot (see pgconn_internal.h)
 };
 
 // Default query options
@@ -38,6 +110,9 @@ static const pgconn_query_opts_t DEFAULT_QUERY_OPTS = {
 static void set_error(pgconn_t* conn, const char* message) {
     if (!conn) return;
 
+    conn->last_sqlstate[0] = '\0';
+    conn->timed_out        = false;
+
     if (!message || message[0] == '\0') {
         conn->last_error[0] = '\0';
         return;
@@ -46,6 +121,16 @@ static void set_error(pgconn_t* conn, const char* message) {
     snprintf(conn->last_error, sizeof(conn->last_error), "%s", message);
 }
 
+/** Sets the error message and SQLSTATE from a failed result. */
+static void set_result_error(pgconn_t* conn, const PGresult* res) {
+    set_error(conn, PQresultErrorMessage(res));
+
+    const char* sqlstate = PQresultErrorField(res, PG_DIAG_SQLSTATE);
+    if (conn && sqlstate) {
+        snprintf(conn->last_sqlstate, sizeof(conn->last_sqlstate), "%s", sqlstate);
+    }
+}
+
 /** Updates the last activity timestamp. */
 static inline void update_activity(pgconn_t* conn) {
     if (conn) {
@@ -53,17 +138,300 @@ static inline void update_activity(pgconn_t* conn) {
     }
 }
 
-/** Consumes all pending results from the connection. */
+/**
+ * Consumes all pending results from the connection. Stops at a COPY result:
+ * libpq returns it again on every call until the COPY is ended, so draining
+ * past it would never finish.
+ */
 static void consume_results(pgconn_t* conn) {
     if (!conn || !conn->raw_conn) return;
 
+#ifdef LIBPQ_HAS_PIPELINING
+    // Pipelined results belong to pgconn_pipeline_next_result()
+    if (PQpipelineStatus(conn->raw_conn) != PQ_PIPELINE_OFF) return;
+#endif
+
     PGresult* res;
     while ((res = PQgetResult(conn->raw_conn)) != NULL) {
+        ExecStatusType status = PQresultStatus(res);
         PQclear(res);
+        if (status == PGRES_COPY_IN || status == PGRES_COPY_OUT || status == PGRES_COPY_BOTH) {
+            return;
+        }
+    }
+}
+
+/**
+ * Rejects a new command while an asynchronous query, a COPY or a streaming
+ * query owns the connection, which has to be finished with its own functions
+ * first. Draining the connection here would silently discard their results.
+ */
+static bool check_session_idle(pgconn_t* conn) {
+    if (conn->async_active) {
+        set_error(conn, "An asynchronous query is in progress");
+        return false;
+    }
+    if (conn->copy_in_active) {
+        set_error(conn, "A COPY FROM STDIN is in progress");
+        return false;
+    }
+    if (conn->copy_out_active) {
+        set_error(conn, "A COPY TO STDOUT is in progress");
+        return false;
+    }
+    if (conn->stream_active) {
+        set_error(conn, "A streaming query is in progress");
+        return false;
+    }
+    return true;
+}
+
+/** Milliseconds left until an absolute CLOCK_MONOTONIC deadline (0 once it has passed). */
+static int remaining_ms(const struct timespec* deadline) {
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+
+    int64_t left_ns = (int64_t)(deadline->tv_sec - now.tv_sec) * 1000000000LL + (deadline->tv_nsec - now.tv_nsec);
+    if (left_ns <= 0) {
+        return 0;
+    }
+
+    // Round up so poll() never wakes just before the deadline and spins
+    int64_t left_ms = (left_ns + 999999) / 1000000;
+    return left_ms > INT_MAX ? INT_MAX : (int)left_ms;
+}
+
+/** Computes an absolute CLOCK_MONOTONIC deadline timeout_ms from now. */
+static struct timespec deadline_after(int timeout_ms) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+
+    ts.tv_sec += timeout_ms / 1000;
+    ts.tv_nsec += (long)(timeout_ms % 1000) * 1000000L;
+    if (ts.tv_nsec >= 1000000000L) {
+        ts.tv_sec++;
+        ts.tv_nsec -= 1000000000L;
+    }
+    return ts;
+}
+
+#ifndef LIBPQ_HAS_ASYNC_CANCEL
+/** Background thread body: delivers one cancel request, then exits. */
+static void* cancel_thread(void* arg) {
+    PGcancel* cancel = arg;
+    char cancel_err[256];
+    PQcancel(cancel, cancel_err, sizeof(cancel_err));
+    PQfreeCancel(cancel);
+    return NULL;
+}
+#endif
+
+/** Returns a per-thread pseudo-random number (xorshift64*). */
+static uint64_t next_random(void) {
+    static __thread uint64_t state;
+    if (state == 0) {
+        struct timespec ts;
+        clock_gettime(CLOCK_MONOTONIC, &ts);
+        state = ((uint64_t)ts.tv_nsec << 32) ^ (uint64_t)ts.tv_sec ^ (uint64_t)(uintptr_t)&state;
+        state |= 1;
+    }
+
+    state ^= state >> 12;
+    state ^= state << 25;
+    state ^= state >> 27;
+    return state * 2685821657736338717ULL;
+}
+
+/** Picks the backoff before the next reconnection attempt (exponential, full jitter). */
+static int backoff_delay_ms(const pgconn_t* conn) {
+    int base = conn->config.reconnect_base_delay_ms > 0 ? conn->config.reconnect_base_delay_ms
+                                                        : PGCONN_RECONNECT_BASE_DELAY_MS;
+    int max  = conn->config.reconnect_max_delay_ms > 0 ? conn->config.reconnect_max_delay_ms
+                                                       : PGCONN_RECONNECT_MAX_DELAY_MS;
+    if (max < base) {
+        max = base;
+    }
+
+    int64_t cap = base;
+    for (int i = 1; i < conn->reconnect_attempts && cap < max; i++) {
+        cap *= 2;
+    }
+    if (cap > max) {
+        cap = max;
+    }
+
+    return (int)(next_random() % (uint64_t)(cap + 1));
+}
+
+/** Closes the underlying connection after it was left in an unknown state. */
+static void close_raw_connection(pgconn_t* conn) {
+    if (conn->config.connection_close) {
+        conn->config.connection_close(conn->raw_conn);
+    }
+    PQfinish(conn->raw_conn);
+    conn->raw_conn = NULL;
+}
+
+/**
+ * Cancels the running query without blocking on the cancel connection, then
+ * drains its remaining results so the connection is idle again.
+ *
+ * With libpq 17+ the cancel request is driven by PQcancelPoll() alongside the
+ * drain. Older libpq has only the blocking PQcancel(), which is handed to a
+ * detached thread. Either way the caller never waits for a TCP handshake to
+ * the server before it starts draining.
+ *
+ * If the query does not finish within PGCONN_CANCEL_DRAIN_MS, or the
+ * connection fails meanwhile, the connection is closed (raw_conn becomes NULL)
+ * so it is never reused with results of the cancelled query still pending.
+ *
+ * @return true if the connection is idle, false if it was closed.
+ */
+static bool cancel_and_drain(pgconn_t* conn) {
+    PGconn* raw = conn->raw_conn;
+
+#ifdef LIBPQ_HAS_ASYNC_CANCEL
+    PGcancelConn* cancel = PQcancelCreate(raw);
+    if (cancel && !PQcancelStart(cancel)) {
+        PQcancelFinish(cancel);
+        cancel = NULL;
+    }
+    // The cancel connection starts out waiting to write its request
+    PostgresPollingStatusType cancel_state = PGRES_POLLING_WRITING;
+#else
+    PGcancel* cancel = PQgetCancel(raw);
+    if (cancel) {
+        pthread_t thread;
+        pthread_attr_t attr;
+        pthread_attr_init(&attr);
+        pthread_attr_setdetachstate(&attr, PTHREAD_CREATE_DETACHED);
+        if (pthread_create(&thread, &attr, cancel_thread, cancel) != 0) {
+            cancel_thread(cancel);  // No thread available: cancel inline
+        }
+        pthread_attr_destroy(&attr);
+    }
+#endif
+
+    struct timespec deadline = deadline_after(PGCONN_CANCEL_DRAIN_MS);
+    bool drained             = false;
+
+    while (true) {
+        if (PQconsumeInput(raw) == 0) {
+            break;
+        }
+
+        // Discard everything that is ready without blocking
+        bool need_input = false;
+        while (!need_input && !PQisBusy(raw)) {
+            PGresult* res = PQgetResult(raw);
+            if (!res) {
+#ifdef LIBPQ_HAS_PIPELINING
+                // In a pipeline, NULL only separates queries until the last sync point
+                if (PQpipelineStatus(raw) != PQ_PIPELINE_OFF && conn->pipeline_syncs > 0) {
+                    continue;
+                }
+#endif
+                drained = true;
+                break;
+            }
+
+            char* buf;
+            int copied;
+            switch (PQresultStatus(res)) {
+                case PGRES_COPY_OUT:
+                    while ((copied = PQgetCopyData(raw, &buf, 1)) > 0) {
+                        PQfreemem(buf);
+                    }
+                    need_input = (copied == 0);
+                    break;
+
+                case PGRES_COPY_IN:
+                    PQputCopyEnd(raw, "query cancelled");
+                    break;
+
+#ifdef LIBPQ_HAS_PIPELINING
+                case PGRES_PIPELINE_SYNC:
+                    conn->pipeline_syncs--;
+                    break;
+#endif
+
+                default:
+                    if (conn->pipeline_queued > 0) {
+                        conn->pipeline_queued--;
+                    }
+                    break;
+            }
+            PQclear(res);
+        }
+
+        if (drained || PQstatus(raw) == CONNECTION_BAD) {
+            break;
+        }
+
+        int timeout = remaining_ms(&deadline);
+        if (timeout == 0) {
+            break;
+        }
+
+        struct pollfd pfds[2] = {{.fd = PQsocket(raw), .events = POLLIN}};
+        nfds_t n_fds          = 1;
+
+#ifdef LIBPQ_HAS_ASYNC_CANCEL
+        if (cancel) {
+            pfds[1].fd     = PQcancelSocket(cancel);
+            pfds[1].events = cancel_state == PGRES_POLLING_READING ? POLLIN : POLLOUT;
+            n_fds          = 2;
+        }
+#endif
+
+        if (poll(pfds, n_fds, timeout) < 0 && errno != EINTR) {
+            break;
+        }
+
+#ifdef LIBPQ_HAS_ASYNC_CANCEL
+        if (cancel && pfds[1].revents) {
+            cancel_state = PQcancelPoll(cancel);
+            if (cancel_state == PGRES_POLLING_OK || cancel_state == PGRES_POLLING_FAILED) {
+                PQcancelFinish(cancel);
+                cancel = NULL;
+            }
+        }
+#endif
+    }
+
+#ifdef LIBPQ_HAS_ASYNC_CANCEL
+    if (cancel) {
+        PQcancelFinish(cancel);
     }
+#endif
+
+    update_activity(conn);
+
+    if (!drained) {
+        close_raw_connection(conn);
+    }
+    return drained;
 }
 
-/** Waits for query completion with optional timeout. */
+/** Cancels a query that ran past its timeout and records the timeout error. */
+static void fail_timed_out(pgconn_t* conn) {
+    // Bring the connection back to idle, or close it if the query does not stop
+    if (cancel_and_drain(conn)) {
+        set_error(conn, "Query execution timed out");
+    } else {
+        set_error(conn, "Query execution timed out; connection closed after the cancelled query did not finish");
+    }
+    conn->timed_out = true;
+}
+
+/**
+ * Waits for query completion with optional timeout.
+ *
+ * The timeout is an absolute deadline for the whole wait, so wakeups for
+ * partial input do not extend it. While libpq still has output queued (large
+ * parameter payloads), the socket is also watched for writability and the
+ * queue is flushed as it drains.
+ */
 static bool wait_for_result(pgconn_t* conn, int timeout_ms) {
     if (!conn || !conn->raw_conn) {
         set_error(conn, "Invalid connection");
@@ -76,90 +444,253 @@ static bool wait_for_result(pgconn_t* conn, int timeout_ms) {
         return false;
     }
 
-    fd_set read_fds;
-    struct timeval tv;
-    struct timeval* tv_ptr = NULL;
-
+    struct timespec deadline = {0, 0};
     if (timeout_ms >= 0) {
-        tv.tv_sec = timeout_ms / 1000;
-        tv.tv_usec = (timeout_ms % 1000) * 1000;
-        tv_ptr = &tv;
+        deadline = deadline_after(timeout_ms);
     }
 
     while (true) {
-        FD_ZERO(&read_fds);
-        FD_SET(socket_fd, &read_fds);
+        int flushed = PQflush(conn->raw_conn);
+        if (flushed < 0) {
+            set_error(conn, PQerrorMessage(conn->raw_conn));
+            return false;
+        }
+
+        if (flushed == 0 && PQisBusy(conn->raw_conn) == 0) {
+            return true;  // Query completed
+        }
 
-        int result = select(socket_fd + 1, &read_fds, NULL, NULL, tv_ptr);
+        struct pollfd pfd = {
+          .fd     = socket_fd,
+          .events = (short)(POLLIN | (flushed == 1 ? POLLOUT : 0)),
+        };
+
+        int result = poll(&pfd, 1, timeout_ms >= 0 ? remaining_ms(&deadline) : -1);
 
         if (result == 0) {
-            // Timeout occurred
-            set_error(conn, "Query execution timed out");
-
-            // Attempt to cancel the query
-            PGcancel* cancel = PQgetCancel(conn->raw_conn);
-            if (cancel) {
-                char cancel_err[256];
-                PQcancel(cancel, cancel_err, sizeof(cancel_err));
-                PQfreeCancel(cancel);
+            fail_timed_out(conn);
+            return false;
+        }
+
+        if (result < 0) {
+            if (errno == EINTR) {
+                continue;  // Interrupted by signal, retry with the time that is left
             }
 
+            char err_buf[256];
+            snprintf(err_buf, sizeof(err_buf), "poll() failed: %s", strerror(errno));
+            set_error(conn, err_buf);
+            return false;
+        }
+
+        // Data available (or the socket failed), consume input
+        if ((pfd.revents & (POLLIN | POLLERR | POLLHUP | POLLNVAL)) && PQconsumeInput(conn->raw_conn) == 0) {
+            set_error(conn, PQerrorMessage(conn->raw_conn));
+            return false;
+        }
+    }
+}
+
+/**
+ * Waits until more COPY TO STDOUT data has been read into libpq's buffer.
+ *
+ * wait_for_result() cannot be used here: PQisBusy() reports 0 throughout
+ * the COPY_OUT state, so it would return without reading anything.
+ */
+static bool wait_for_copy_data(pgconn_t* conn, int timeout_ms) {
+    int socket_fd = PQsocket(conn->raw_conn);
+    if (socket_fd < 0) {
+        set_error(conn, "Invalid socket file descriptor");
+        return false;
+    }
+
+    struct timespec deadline = {0, 0};
+    if (timeout_ms >= 0) {
+        deadline = deadline_after(timeout_ms);
+    }
+
+    while (true) {
+        struct pollfd pfd = {.fd = socket_fd, .events = POLLIN};
+        int result        = poll(&pfd, 1, timeout_ms >= 0 ? remaining_ms(&deadline) : -1);
+
+        if (result == 0) {
+            fail_timed_out(conn);
             return false;
         }
 
         if (result < 0) {
             if (errno == EINTR) {
-                continue;  // Interrupted by signal, retry
+                continue;
             }
 
             char err_buf[256];
-            snprintf(err_buf, sizeof(err_buf), "select() failed: %s", strerror(errno));
+            snprintf(err_buf, sizeof(err_buf), "poll() failed: %s", strerror(errno));
             set_error(conn, err_buf);
             return false;
         }
 
-        // Data available, consume input
         if (PQconsumeInput(conn->raw_conn) == 0) {
             set_error(conn, PQerrorMessage(conn->raw_conn));
             return false;
         }
+        return true;
+    }
+}
 
-        if (PQisBusy(conn->raw_conn) == 0) {
-            return true;  // Query completed
+/**
+ * Waits until libpq's output queue of a nonblocking connection has been sent.
+ *
+ * Input is read meanwhile, so a server that reports an error instead of
+ * reading cannot stall the wait; the timeout is a deadline for the whole wait.
+ */
+static bool wait_for_output(pgconn_t* conn, int timeout_ms) {
+    int socket_fd = PQsocket(conn->raw_conn);
+    if (socket_fd < 0) {
+        set_error(conn, "Invalid socket file descriptor");
+        return false;
+    }
+
+    struct timespec deadline = {0, 0};
+    if (timeout_ms >= 0) {
+        deadline = deadline_after(timeout_ms);
+    }
+
+    while (true) {
+        int flushed = PQflush(conn->raw_conn);
+        if (flushed < 0) {
+            set_error(conn, PQerrorMessage(conn->raw_conn));
+            return false;
+        }
+        if (flushed == 0) {
+            return true;
+        }
+
+        struct pollfd pfd = {.fd = socket_fd, .events = POLLIN | POLLOUT};
+        int result        = poll(&pfd, 1, timeout_ms >= 0 ? remaining_ms(&deadline) : -1);
+
+        if (result == 0) {
+            fail_timed_out(conn);
+            return false;
+        }
+
+        if (result < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+
+            char err_buf[256];
+            snprintf(err_buf, sizeof(err_buf), "poll() failed: %s", strerror(errno));
+            set_error(conn, err_buf);
+            return false;
+        }
+
+        if ((pfd.revents & (POLLIN | POLLERR | POLLHUP | POLLNVAL)) && PQconsumeInput(conn->raw_conn) == 0) {
+            set_error(conn, PQerrorMessage(conn->raw_conn));
+            return false;
         }
     }
 }
 
-/** Internal connection creation without locking. */
-static PGconn* create_raw_connection(const pgconn_config_t* config) {
-    if (!config || !config->conninfo) {
-        fprintf(stderr, "pgconn: Invalid configuration\n");
-        return NULL;
+/** Frees one prepared statement registry entry. */
+static void free_prepared_entry(prepared_entry_t* entry) {
+    free(entry->name);
+    free(entry->query);
+    free(entry->param_types);
+    free(entry);
+}
+
+/** Removes a statement from the registry. */
+static void unregister_prepared(pgconn_t* conn, const char* name) {
+    for (prepared_entry_t** link = &conn->prepared; *link; link = &(*link)->next) {
+        if (strcmp((*link)->name, name) == 0) {
+            prepared_entry_t* entry = *link;
+            *link                   = entry->next;
+            free_prepared_entry(entry);
+            return;
+        }
     }
+}
 
-    PGconn* raw = PQconnectdb(config->conninfo);
-    if (!raw) {
-        fprintf(stderr, "pgconn: PQconnectdb failed to allocate connection\n");
-        return NULL;
+/** Records a prepared statement so a reconnect can restore it. Best effort on allocation failure. */
+static void register_prepared(pgconn_t* conn, const char* name, const char* query, int n_params,
+                              const Oid* param_types) {
+    unregister_prepared(conn, name);
+
+    prepared_entry_t* entry = calloc(1, sizeof(prepared_entry_t));
+    if (!entry) {
+        return;
     }
 
-    if (PQstatus(raw) != CONNECTION_OK) {
-        fprintf(stderr, "pgconn: Connection failed: %s\n", PQerrorMessage(raw));
-        PQfinish(raw);
-        return NULL;
+    entry->name  = strdup(name);
+    entry->query = strdup(query);
+    if (param_types && n_params > 0) {
+        entry->param_types = malloc((size_t)n_params * sizeof(Oid));
+        if (entry->param_types) {
+            memcpy(entry->param_types, param_types, (size_t)n_params * sizeof(Oid));
+            entry->n_params = n_params;
+        }
     }
 
-    // Call initialization callback if provided
-    if (config->connection_init) {
-        config->connection_init(raw);
+    if (!entry->name || !entry->query || (n_params > 0 && param_types && !entry->param_types)) {
+        free_prepared_entry(entry);
+        return;
+    }
+
+    entry->next    = conn->prepared;
+    conn->prepared = entry;
+}
+
+/** Frees the whole prepared statement registry. */
+static void free_prepared_registry(pgconn_t* conn) {
+    while (conn->prepared) {
+        prepared_entry_t* next = conn->prepared->next;
+        free_prepared_entry(conn->prepared);
+        conn->prepared = next;
+    }
+}
+
+/**
+ * Prepares every registered statement on a fresh session. Failures are not
+ * fatal: executing the missing statement reports the server's error.
+ */
+static void reprepare_registered(pgconn_t* conn) {
+    conn->reprepare_pending = false;
+
+    for (prepared_entry_t* entry = conn->prepared; entry; entry = entry->next) {
+        PGresult* res = PQprepare(conn->raw_conn, entry->name, entry->query, entry->n_params, entry->param_types);
+        PQclear(res);
+    }
+}
+
+/** Restores registered statements if a reconnect left them pending. */
+static inline void ensure_prepared(pgconn_t* conn) {
+    if (conn->reprepare_pending && conn->raw_conn && PQstatus(conn->raw_conn) == CONNECTION_OK) {
+        reprepare_registered(conn);
+    }
+}
+
+/** Frees every statement cache entry without touching the server. */
+static void stmt_cache_clear(pgconn_t* conn) {
+    stmt_entry_t* entry = conn->stmt_lru_head;
+    while (entry) {
+        stmt_entry_t* next = entry->lru_next;
+        free(entry->sql);
+        free(entry);
+        entry = next;
     }
 
-    return raw;
+    if (conn->stmt_buckets) {
+        memset(conn->stmt_buckets, 0, (conn->stmt_bucket_mask + 1) * sizeof(stmt_entry_t*));
+    }
+    conn->stmt_lru_head = NULL;
+    conn->stmt_lru_tail = NULL;
+    conn->stmt_count    = 0;
 }
 
 // === Connection Management ===
 
-pgconn_t* pgconn_create(const pgconn_config_t* config) {
+/** Allocates a connection wrapper with a private copy of the configuration. */
+static pgconn_t* alloc_connection(const pgconn_config_t* config) {
     if (!config || !config->conninfo) {
         fprintf(stderr, "pgconn: config and config->conninfo must not be NULL\n");
         return NULL;
@@ -195,33 +726,174 @@ pgconn_t* pgconn_create(const pgconn_config_t* config) {
     // Assign unique connection ID
     conn->connection_id = __atomic_fetch_add(&g_next_conn_id, 1, __ATOMIC_RELAXED);
 
-    // Create the actual connection
-    conn->raw_conn = create_raw_connection(config);
+    return conn;
+}
+
+/** Frees a wrapper from alloc_connection() that never finished connecting. */
+static void free_connection(pgconn_t* conn) {
+    if (conn->raw_conn) {
+        PQfinish(conn->raw_conn);
+    }
+    if (conn->thread_safe) {
+        pthread_mutex_destroy(&conn->lock);
+    }
+    free((void*)conn->config.conninfo);
+    free(conn);
+}
+
+/**
+ * Starts a non-blocking connection attempt. Failures to even start are
+ * reported by the next pgconn_connect_poll(), so callers only check allocation.
+ */
+static void start_connect(pgconn_t* conn) {
+    set_error(conn, NULL);
+
+    conn->raw_conn      = PQconnectStart(conn->config.conninfo);
+    conn->connecting    = true;
+    conn->connect_state = PGRES_POLLING_WRITING;  // Per libpq, act as if the last poll asked to write
+
+    conn->connect_deadline_set = conn->config.connect_timeout > 0;
+    if (conn->connect_deadline_set) {
+        conn->connect_deadline = deadline_after(conn->config.connect_timeout * 1000);
+    }
+}
+
+/** Ends a failed connection attempt. */
+static pgconn_poll_status_t fail_connect(pgconn_t* conn, const char* message) {
+    set_error(conn, message);
+    if (conn->raw_conn) {
+        PQfinish(conn->raw_conn);
+        conn->raw_conn = NULL;
+    }
+    conn->connecting = false;
+
+    // A failed reconnect delays the next one so clients spread out after an outage
+    if (conn->reconnect_attempts > 0) {
+        conn->backoff_until = deadline_after(backoff_delay_ms(conn));
+        conn->backoff_set   = true;
+    }
+    return PGCONN_POLL_FAILED;
+}
+
+pgconn_poll_status_t pgconn_connect_poll(pgconn_t* conn) {
+    if (!conn || !conn->connecting) {
+        set_error(conn, "No connection attempt in progress");
+        return PGCONN_POLL_FAILED;
+    }
+
     if (!conn->raw_conn) {
-        if (conn->thread_safe) {
-            pthread_mutex_destroy(&conn->lock);
+        return fail_connect(conn, "Memory allocation failed");
+    }
+
+    if (PQstatus(conn->raw_conn) == CONNECTION_BAD) {
+        return fail_connect(conn, PQerrorMessage(conn->raw_conn));
+    }
+
+    if (conn->connect_deadline_set && remaining_ms(&conn->connect_deadline) == 0) {
+        return fail_connect(conn, "Connection timed out");
+    }
+
+    // PQconnectPoll() may block if the socket is not ready yet, so check first.
+    // This makes early or spurious calls (e.g. from a timer) harmless.
+    bool want_read    = conn->connect_state == PGRES_POLLING_READING;
+    struct pollfd pfd = {.fd = PQsocket(conn->raw_conn), .events = want_read ? POLLIN : POLLOUT};
+    if (pfd.fd >= 0 && poll(&pfd, 1, 0) == 0) {
+        return want_read ? PGCONN_POLL_READING : PGCONN_POLL_WRITING;
+    }
+
+    conn->connect_state = PQconnectPoll(conn->raw_conn);
+    switch (conn->connect_state) {
+        case PGRES_POLLING_READING:
+            return PGCONN_POLL_READING;
+
+        case PGRES_POLLING_WRITING:
+            return PGCONN_POLL_WRITING;
+
+        case PGRES_POLLING_OK:
+            break;
+
+        default:
+            return fail_connect(conn, PQerrorMessage(conn->raw_conn));
+    }
+
+    conn->connecting = false;
+
+    // Call initialization callback if provided
+    if (conn->config.connection_init) {
+        conn->config.connection_init(conn->raw_conn);
+    }
+
+    conn->reconnect_attempts = 0;
+    conn->backoff_set        = false;
+    conn->last_activity      = time(NULL);
+    conn->created_at         = conn->last_activity;
+    return PGCONN_POLL_DONE;
+}
+
+/** Runs a connection attempt to completion, honoring connect_timeout. */
+static bool connect_blocking(pgconn_t* conn) {
+    start_connect(conn);
+
+    while (true) {
+        pgconn_poll_status_t status = pgconn_connect_poll(conn);
+        if (status == PGCONN_POLL_DONE) {
+            return true;
         }
-        free((void*)conn->config.conninfo);
-        free(conn);
+        if (status == PGCONN_POLL_FAILED) {
+            return false;
+        }
+
+        // The socket may change between polls (e.g. trying the next host)
+        struct pollfd pfd = {
+          .fd     = PQsocket(conn->raw_conn),
+          .events = status == PGCONN_POLL_READING ? POLLIN : POLLOUT,
+        };
+
+        int timeout = conn->connect_deadline_set ? remaining_ms(&conn->connect_deadline) : -1;
+        if (poll(&pfd, 1, timeout) < 0 && errno != EINTR) {
+            char err_buf[256];
+            snprintf(err_buf, sizeof(err_buf), "poll() failed: %s", strerror(errno));
+            fail_connect(conn, err_buf);
+            return false;
+        }
+    }
+}
+
+pgconn_t* pgconn_create(const pgconn_config_t* config) {
+    pgconn_t* conn = alloc_connection(config);
+    if (!conn) {
+        return NULL;
+    }
+
+    // Create the actual connection
+    if (!connect_blocking(conn)) {
+        fprintf(stderr, "pgconn: Connection failed: %s\n", conn->last_error);
+        free_connection(conn);
         return NULL;
     }
 
-    conn->last_activity = time(NULL);
+    return conn;
+}
 
+pgconn_t* pgconn_connect_start(const pgconn_config_t* config) {
+    pgconn_t* conn = alloc_connection(config);
+    if (conn) {
+        start_connect(conn);
+    }
     return conn;
 }
 
 void pgconn_destroy(pgconn_t* conn) {
     if (!conn) return;
 
-    // Rollback active transaction if any
-    if (conn->transaction_active && conn->raw_conn) {
+    // Rollback active transaction if any (closing the session rolls it back during a COPY or stream)
+    if (conn->transaction_active && conn->raw_conn && !pgconn_session_busy(conn)) {
         PGresult* res = PQexec(conn->raw_conn, "ROLLBACK");
         PQclear(res);
     }
 
-    // Call close callback if provided
-    if (conn->config.connection_close && conn->raw_conn) {
+    // Call close callback if provided (only connections that finished connecting were initialized)
+    if (conn->config.connection_close && conn->raw_conn && !conn->connecting) {
         conn->config.connection_close(conn->raw_conn);
     }
 
@@ -230,7 +902,18 @@ void pgconn_destroy(pgconn_t* conn) {
         conn->raw_conn = NULL;
     }
 
+    stmt_cache_clear(conn);
+    free(conn->stmt_buckets);
+    free_prepared_registry(conn);
+    PQclear(conn->async_result);
+
     free((void*)conn->config.conninfo);
+    free(conn->copy_buf);
+    free(conn->copy_values);
+    free(conn->copy_lengths);
+    if (conn->copy_chunk) {
+        PQfreemem(conn->copy_chunk);
+    }
 
     if (conn->thread_safe) {
         pthread_mutex_destroy(&conn->lock);
@@ -252,14 +935,22 @@ bool pgconn_validate(pgconn_t* conn) {
         return false;
     }
 
-    // Simple validation query
-    PGresult* res = PQexec(conn->raw_conn, "SELECT 1");
-    if (!res) {
+    // Simple validation query, bounded so a silently dropped peer cannot
+    // block the caller for the TCP retransmission timeout
+    consume_results(conn);
+    if (PQsendQuery(conn->raw_conn, "SELECT 1") != 1) {
+        set_error(conn, PQerrorMessage(conn->raw_conn));
         return false;
     }
 
-    ExecStatusType status = PQresultStatus(res);
+    if (!wait_for_result(conn, PGCONN_VALIDATE_TIMEOUT_MS)) {
+        return false;
+    }
+
+    PGresult* res         = PQgetResult(conn->raw_conn);
+    ExecStatusType status = res ? PQresultStatus(res) : PGRES_FATAL_ERROR;
     PQclear(res);
+    consume_results(conn);
 
     return (status == PGRES_TUPLES_OK);
 }
@@ -280,11 +971,53 @@ bool pgconn_validate_safe(pgconn_t* conn) {
     return result;
 }
 
-bool pgconn_reconnect(pgconn_t* conn) {
-    if (!conn) {
+bool pgconn_validate_fast(pgconn_t* conn, int max_idle_s) {
+    if (!conn || !conn->raw_conn || PQstatus(conn->raw_conn) != CONNECTION_OK) {
+        return false;
+    }
+
+    // An idle connection has nothing to read, so a readable socket means EOF,
+    // an error sent before the server closed it, or a notification.
+    struct pollfd pfd = {.fd = PQsocket(conn->raw_conn), .events = POLLIN, .revents = 0};
+    if (pfd.fd < 0) {
         return false;
     }
 
+    if (poll(&pfd, 1, 0) > 0) {
+        if (pfd.revents & (POLLERR | POLLNVAL)) {
+            return false;
+        }
+        if (!PQconsumeInput(conn->raw_conn) || PQstatus(conn->raw_conn) != CONNECTION_OK) {
+            return false;
+        }
+    }
+
+    // Only a round trip catches a silently dropped peer; save it for connections idle long enough
+    if (max_idle_s < 0 || time(NULL) - conn->last_activity < max_idle_s) {
+        return true;
+    }
+
+    return pgconn_validate(conn);
+}
+
+bool pgconn_validate_fast_safe(pgconn_t* conn, int max_idle_s) {
+    if (!conn) return false;
+
+    if (conn->thread_safe) {
+        pthread_mutex_lock(&conn->lock);
+    }
+
+    bool result = pgconn_validate_fast(conn, max_idle_s);
+
+    if (conn->thread_safe) {
+        pthread_mutex_unlock(&conn->lock);
+    }
+
+    return result;
+}
+
+/** Closes the current session and resets all per-session state before reconnecting. */
+static bool reset_for_reconnect(pgconn_t* conn) {
     // Check reconnection limits
     if (conn->config.max_reconnect_attempts > 0 && conn->reconnect_attempts >= conn->config.max_reconnect_attempts) {
         set_error(conn, "Maximum reconnection attempts exceeded");
@@ -293,26 +1026,77 @@ bool pgconn_reconnect(pgconn_t* conn) {
 
     // Close existing connection
     if (conn->raw_conn) {
-        if (conn->config.connection_close) {
+        if (conn->config.connection_close && !conn->connecting) {
             conn->config.connection_close(conn->raw_conn);
         }
         PQfinish(conn->raw_conn);
         conn->raw_conn = NULL;
     }
 
-    // Reset transaction state
+    // Reset transaction and pipeline state
     conn->transaction_active = false;
+    conn->pipeline_queued    = 0;
+    conn->pipeline_syncs     = 0;
+    conn->copy_in_active     = false;
+    conn->copy_len           = 0;
+    conn->copy_out_active    = false;
+    conn->stream_active      = false;
+    conn->async_active       = false;
+    PQclear(conn->async_result);
+    conn->async_result = NULL;
+
+    // Prepared statements died with the old session
+    stmt_cache_clear(conn);
+    conn->reprepare_pending = conn->prepared != NULL;
+    if (conn->copy_chunk) {
+        PQfreemem(conn->copy_chunk);
+        conn->copy_chunk = NULL;
+    }
     conn->reconnect_attempts++;
+    conn->connecting = false;
 
-    // Create new connection
-    conn->raw_conn = create_raw_connection(&conn->config);
-    if (!conn->raw_conn) {
+    return true;
+}
+
+bool pgconn_reconnect(pgconn_t* conn) {
+    if (!conn) {
+        return false;
+    }
+
+    // Sit out the backoff of the previous failed attempt
+    if (conn->backoff_set && pgconn_reconnect_delay_ms(conn) > 0) {
+        while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &conn->backoff_until, NULL) == EINTR) {
+        }
+    }
+
+    if (!reset_for_reconnect(conn)) {
+        return false;
+    }
+
+    // Create new connection (reconnect_attempts is reset on success)
+    if (!connect_blocking(conn)) {
+        return false;
+    }
+
+    ensure_prepared(conn);
+    return true;
+}
+
+bool pgconn_reconnect_start(pgconn_t* conn) {
+    if (!conn) {
+        return false;
+    }
+
+    if (pgconn_reconnect_delay_ms(conn) > 0) {
+        set_error(conn, "Reconnection delayed by backoff after a failed attempt");
         return false;
     }
 
-    conn->reconnect_attempts = 0;  // Reset on success
-    conn->last_activity = time(NULL);
+    if (!reset_for_reconnect(conn)) {
+        return false;
+    }
 
+    start_connect(conn);
     return true;
 }
 
@@ -332,9 +1116,107 @@ bool pgconn_reconnect_safe(pgconn_t* conn) {
     return result;
 }
 
+int pgconn_reconnect_delay_ms(pgconn_t* conn) {
+    if (!conn || !conn->backoff_set) {
+        return 0;
+    }
+
+    return remaining_ms(&conn->backoff_until);
+}
+
+int pgconn_reconnect_delay_ms_safe(pgconn_t* conn) {
+    if (!conn) return 0;
+
+    if (conn->thread_safe) {
+        pthread_mutex_lock(&conn->lock);
+    }
+
+    int result = pgconn_reconnect_delay_ms(conn);
+
+    if (conn->thread_safe) {
+        pthread_mutex_unlock(&conn->lock);
+    }
+
+    return result;
+}
+
+// === Connection Recovery ===
+
+/** Checks whether the last failure means the session is gone (CONNECTION_BAD or SQLSTATE class 08). */
+static bool connection_lost(const pgconn_t* conn) {
+    return PQstatus(conn->raw_conn) == CONNECTION_BAD || strncmp(conn->last_sqlstate, "08", 2) == 0;
+}
+
+/**
+ * Prepares a query for automatic recovery. With auto_reconnect, a connection
+ * already known to be dead is reopened before anything is sent, except inside
+ * a transaction: there the failure must reach the caller, and reconnecting
+ * would silently run the rest of the transaction in autocommit mode. While the
+ * backoff of a failed attempt runs, the query fails at once instead of
+ * sleeping past its timeout; only pgconn_reconnect() itself waits it out.
+ *
+ * @param in_transaction Set to whether a transaction was active, for recover_connection().
+ * @return false if the query must not be sent.
+ */
+static bool begin_recoverable(pgconn_t* conn, bool* in_transaction) {
+    *in_transaction = conn && conn->transaction_active;
+    if (!conn) {
+        return true;  // The query itself reports the invalid connection
+    }
+
+    if (conn->config.auto_reconnect && !conn->transaction_active && !conn->connecting &&
+        (!conn->raw_conn || PQstatus(conn->raw_conn) == CONNECTION_BAD)) {
+        if (pgconn_reconnect_delay_ms(conn) > 0) {
+            set_error(conn, "Connection lost; reconnection delayed by backoff after a failed attempt");
+            return false;
+        }
+        pgconn_reconnect(conn);
+    }
+    return true;
+}
+
+/**
+ * Recovers from a failed query. If the connection was lost and auto_reconnect
+ * is set, reconnects (re-preparing registered statements). Returns true only
+ * when the query should run again: retry_on_failure was requested, no
+ * transaction was open and the query did not time out. Otherwise the original
+ * error is kept.
+ */
+static bool recover_connection(pgconn_t* conn, const pgconn_query_opts_t* opts, bool in_transaction) {
+    if (!conn || !conn->config.auto_reconnect || in_transaction || !conn->raw_conn || !connection_lost(conn)) {
+        return false;
+    }
+
+    // Keep the original error rather than sleep through the backoff inside a query
+    if (pgconn_reconnect_delay_ms(conn) > 0) {
+        return false;
+    }
+
+    bool retry = opts->retry_on_failure && !conn->timed_out;
+
+    char error[PGCONN_ERR_CAPACITY];
+    char sqlstate[sizeof(conn->last_sqlstate)];
+    memcpy(error, conn->last_error, sizeof(error));
+    memcpy(sqlstate, conn->last_sqlstate, sizeof(sqlstate));
+
+    if (!pgconn_reconnect(conn)) {
+        return false;
+    }
+
+    if (!retry) {
+        set_error(conn, error);
+        memcpy(conn->last_sqlstate, sqlstate, sizeof(sqlstate));
+        return false;
+    }
+
+    set_error(conn, NULL);
+    return true;
+}
+
 // === Simple Query Execution ===
 
-bool pgconn_execute(pgconn_t* conn, const char* query, const pgconn_query_opts_t* opts) {
+/** Runs a query once, without recovery. */
+static bool execute_once(pgconn_t* conn, const char* query, const pgconn_query_opts_t* opts) {
     if (!conn || !conn->raw_conn || !query) {
         set_error(conn, "Invalid connection or query");
         return false;
@@ -344,6 +1226,10 @@ bool pgconn_execute(pgconn_t* conn, const char* query, const pgconn_query_opts_t
         opts = &DEFAULT_QUERY_OPTS;
     }
 
+    if (!check_session_idle(conn)) {
+        return false;
+    }
+
     consume_results(conn);
     set_error(conn, NULL);
 
@@ -359,7 +1245,7 @@ bool pgconn_execute(pgconn_t* conn, const char* query, const pgconn_query_opts_t
         bool success = (status == PGRES_COMMAND_OK || status == PGRES_TUPLES_OK);
 
         if (!success) {
-            set_error(conn, PQresultErrorMessage(res));
+            set_result_error(conn, res);
         }
 
         PQclear(res);
@@ -387,7 +1273,7 @@ bool pgconn_execute(pgconn_t* conn, const char* query, const pgconn_query_opts_t
     bool success = (status == PGRES_COMMAND_OK || status == PGRES_TUPLES_OK);
 
     if (!success) {
-        set_error(conn, PQresultErrorMessage(res));
+        set_result_error(conn, res);
     }
 
     PQclear(res);
@@ -397,6 +1283,23 @@ bool pgconn_execute(pgconn_t* conn, const char* query, const pgconn_query_opts_t
     return success;
 }
 
+bool pgconn_execute(pgconn_t* conn, const char* query, const pgconn_query_opts_t* opts) {
+    if (!opts) {
+        opts = &DEFAULT_QUERY_OPTS;
+    }
+
+    bool in_transaction;
+    if (!begin_recoverable(conn, &in_transaction)) {
+        return false;
+    }
+
+    bool success = execute_once(conn, query, opts);
+    if (!success && recover_connection(conn, opts, in_transaction)) {
+        success = execute_once(conn, query, opts);
+    }
+    return success;
+}
+
 bool pgconn_execute_safe(pgconn_t* conn, const char* query, const pgconn_query_opts_t* opts) {
     if (!conn) return false;
 
@@ -413,7 +1316,8 @@ bool pgconn_execute_safe(pgconn_t* conn, const char* query, const pgconn_query_o
     return result;
 }
 
-PGresult* pgconn_query(pgconn_t* conn, const char* query, const pgconn_query_opts_t* opts) {
+/** Runs a query once, without recovery. */
+static PGresult* query_once(pgconn_t* conn, const char* query, const pgconn_query_opts_t* opts) {
     if (!conn || !conn->raw_conn || !query) {
         set_error(conn, "Invalid connection or query");
         return NULL;
@@ -423,6 +1327,10 @@ PGresult* pgconn_query(pgconn_t* conn, const char* query, const pgconn_query_opt
         opts = &DEFAULT_QUERY_OPTS;
     }
 
+    if (!check_session_idle(conn)) {
+        return NULL;
+    }
+
     consume_results(conn);
     set_error(conn, NULL);
 
@@ -436,7 +1344,7 @@ PGresult* pgconn_query(pgconn_t* conn, const char* query, const pgconn_query_opt
 
         ExecStatusType status = PQresultStatus(res);
         if (status != PGRES_COMMAND_OK && status != PGRES_TUPLES_OK) {
-            set_error(conn, PQresultErrorMessage(res));
+            set_result_error(conn, res);
             PQclear(res);
             res = NULL;
         }
@@ -463,7 +1371,7 @@ PGresult* pgconn_query(pgconn_t* conn, const char* query, const pgconn_query_opt
 
     ExecStatusType status = PQresultStatus(res);
     if (status != PGRES_COMMAND_OK && status != PGRES_TUPLES_OK) {
-        set_error(conn, PQresultErrorMessage(res));
+        set_result_error(conn, res);
         PQclear(res);
         res = NULL;
     }
@@ -474,6 +1382,23 @@ PGresult* pgconn_query(pgconn_t* conn, const char* query, const pgconn_query_opt
     return res;
 }
 
+PGresult* pgconn_query(pgconn_t* conn, const char* query, const pgconn_query_opts_t* opts) {
+    if (!opts) {
+        opts = &DEFAULT_QUERY_OPTS;
+    }
+
+    bool in_transaction;
+    if (!begin_recoverable(conn, &in_transaction)) {
+        return NULL;
+    }
+
+    PGresult* res = query_once(conn, query, opts);
+    if (!res && recover_connection(conn, opts, in_transaction)) {
+        res = query_once(conn, query, opts);
+    }
+    return res;
+}
+
 PGresult* pgconn_query_safe(pgconn_t* conn, const char* query, const pgconn_query_opts_t* opts) {
     if (!conn) return NULL;
 
@@ -492,9 +1417,10 @@ PGresult* pgconn_query_safe(pgconn_t* conn, const char* query, const pgconn_quer
 
 // === Parameterized Query Execution ===
 
-PGresult* pgconn_query_params_full(pgconn_t* conn, const char* query, int n_params, const Oid* param_types,
-                                   const char* const* param_values, const int* param_lengths, const int* param_formats,
-                                   int result_format, const pgconn_query_opts_t* opts) {
+/** Runs a parameterized query once, without recovery. */
+static PGresult* query_params_once(pgconn_t* conn, const char* query, int n_params, const Oid* param_types,
+                                   const char* const* param_values, const int* param_lengths,
+                                   const int* param_formats, int result_format, const pgconn_query_opts_t* opts) {
     if (!conn || !conn->raw_conn || !query) {
         set_error(conn, "Invalid connection or query");
         return NULL;
@@ -507,6 +1433,10 @@ PGresult* pgconn_query_params_full(pgconn_t* conn, const char* query, int n_para
     // Normalize parameters
     if (n_params < 0) n_params = 0;
 
+    if (!check_session_idle(conn)) {
+        return NULL;
+    }
+
     consume_results(conn);
     set_error(conn, NULL);
 
@@ -521,7 +1451,7 @@ PGresult* pgconn_query_params_full(pgconn_t* conn, const char* query, int n_para
 
         ExecStatusType status = PQresultStatus(res);
         if (status != PGRES_COMMAND_OK && status != PGRES_TUPLES_OK) {
-            set_error(conn, PQresultErrorMessage(res));
+            set_result_error(conn, res);
             PQclear(res);
             res = NULL;
         }
@@ -550,7 +1480,7 @@ PGresult* pgconn_query_params_full(pgconn_t* conn, const char* query, int n_para
 
     ExecStatusType status = PQresultStatus(res);
     if (status != PGRES_COMMAND_OK && status != PGRES_TUPLES_OK) {
-        set_error(conn, PQresultErrorMessage(res));
+        set_result_error(conn, res);
         PQclear(res);
         res = NULL;
     }
@@ -561,6 +1491,27 @@ PGresult* pgconn_query_params_full(pgconn_t* conn, const char* query, int n_para
     return res;
 }
 
+PGresult* pgconn_query_params_full(pgconn_t* conn, const char* query, int n_params, const Oid* param_types,
+                                   const char* const* param_values, const int* param_lengths, const int* param_formats,
+                                   int result_format, const pgconn_query_opts_t* opts) {
+    if (!opts) {
+        opts = &DEFAULT_QUERY_OPTS;
+    }
+
+    bool in_transaction;
+    if (!begin_recoverable(conn, &in_transaction)) {
+        return NULL;
+    }
+
+    PGresult* res = query_params_once(
+        conn, query, n_params, param_types, param_values, param_lengths, param_formats, result_format, opts);
+    if (!res && recover_connection(conn, opts, in_transaction)) {
+        res = query_params_once(
+            conn, query, n_params, param_types, param_values, param_lengths, param_formats, result_format, opts);
+    }
+    return res;
+}
+
 PGresult* pgconn_query_params_full_safe(pgconn_t* conn, const char* query, int n_params, const Oid* param_types,
                                         const char* const* param_values, const int* param_lengths,
                                         const int* param_formats, int result_format, const pgconn_query_opts_t* opts) {
@@ -595,199 +1546,1843 @@ PGresult* pgconn_query_params_safe(pgconn_t* conn, const char* query, int n_para
         pthread_mutex_lock(&conn->lock);
     }
 
-    PGresult* result = pgconn_query_params(conn, query, n_params, param_values, opts);
+    PGresult* result = pgconn_query_params(conn, query, n_params, param_values, opts);
+
+    if (conn->thread_safe) {
+        pthread_mutex_unlock(&conn->lock);
+    }
+
+    return result;
+}
+
+// === Prepared Statements ===
+
+bool pgconn_prepare(pgconn_t* conn, const char* stmt_name, const char* query, int n_params, const Oid* param_types) {
+    if (!conn || !conn->raw_conn || !stmt_name || !query) {
+        set_error(conn, "Invalid connection, statement name, or query");
+        return false;
+    }
+
+    if (!check_session_idle(conn)) {
+        return false;
+    }
+
+    consume_results(conn);
+    set_error(conn, NULL);
+
+    PGresult* res = PQprepare(conn->raw_conn, stmt_name, query, n_params, param_types);
+    if (!res) {
+        set_error(conn, "No result received from prepare");
+        return false;
+    }
+
+    bool success = (PQresultStatus(res) == PGRES_COMMAND_OK);
+    if (success) {
+        register_prepared(conn, stmt_name, query, n_params, param_types);
+    } else {
+        set_result_error(conn, res);
+    }
+
+    PQclear(res);
+    update_activity(conn);
+
+    return success;
+}
+
+bool pgconn_prepare_safe(pgconn_t* conn, const char* stmt_name, const char* query, int n_params,
+                         const Oid* param_types) {
+    if (!conn) return false;
+
+    if (conn->thread_safe) {
+        pthread_mutex_lock(&conn->lock);
+    }
+
+    bool result = pgconn_prepare(conn, stmt_name, query, n_params, param_types);
+
+    if (conn->thread_safe) {
+        pthread_mutex_unlock(&conn->lock);
+    }
+
+    return result;
+}
+
+/** Executes a prepared statement once, without recovery. */
+static PGresult* execute_prepared_once(pgconn_t* conn, const char* stmt_name, int n_params,
+                                       const char* const* param_values, const int* param_lengths,
+                                       const int* param_formats, int result_format,
+                                       const pgconn_query_opts_t* opts) {
+    if (!conn || !conn->raw_conn || !stmt_name) {
+        set_error(conn, "Invalid connection or statement name");
+        return NULL;
+    }
+
+    ensure_prepared(conn);
+
+    if (!opts) {
+        opts = &DEFAULT_QUERY_OPTS;
+    }
+
+    if (!check_session_idle(conn)) {
+        return NULL;
+    }
+
+    consume_results(conn);
+    set_error(conn, NULL);
+
+    // Use PQexecPrepared for simplicity when no timeout
+    if (opts->timeout_ms < 0) {
+        PGresult* res = PQexecPrepared(
+            conn->raw_conn, stmt_name, n_params, param_values, param_lengths, param_formats, result_format);
+        if (!res) {
+            set_error(conn, "No result received from prepared statement");
+            return NULL;
+        }
+
+        ExecStatusType status = PQresultStatus(res);
+        if (status != PGRES_COMMAND_OK && status != PGRES_TUPLES_OK) {
+            set_result_error(conn, res);
+            PQclear(res);
+            res = NULL;
+        }
+
+        update_activity(conn);
+        return res;
+    }
+
+    // With timeout, use async API
+    if (PQsendQueryPrepared(
+            conn->raw_conn, stmt_name, n_params, param_values, param_lengths, param_formats, result_format) != 1) {
+        set_error(conn, PQerrorMessage(conn->raw_conn));
+        return NULL;
+    }
+
+    if (!wait_for_result(conn, opts->timeout_ms)) {
+        return NULL;
+    }
+
+    PGresult* res = PQgetResult(conn->raw_conn);
+    if (!res) {
+        set_error(conn, "No result received from prepared statement");
+        return NULL;
+    }
+
+    ExecStatusType status = PQresultStatus(res);
+    if (status != PGRES_COMMAND_OK && status != PGRES_TUPLES_OK) {
+        set_result_error(conn, res);
+        PQclear(res);
+        res = NULL;
+    }
+
+    consume_results(conn);
+    update_activity(conn);
+
+    return res;
+}
+
+PGresult* pgconn_execute_prepared_full(pgconn_t* conn, const char* stmt_name, int n_params,
+                                       const char* const* param_values, const int* param_lengths,
+                                       const int* param_formats, int result_format, const pgconn_query_opts_t* opts) {
+    if (!opts) {
+        opts = &DEFAULT_QUERY_OPTS;
+    }
+
+    bool in_transaction;
+    if (!begin_recoverable(conn, &in_transaction)) {
+        return NULL;
+    }
+
+    PGresult* res = execute_prepared_once(
+        conn, stmt_name, n_params, param_values, param_lengths, param_formats, result_format, opts);
+
+    // A reconnect re-prepares registered statements, so the retry finds stmt_name again
+    if (!res && recover_connection(conn, opts, in_transaction)) {
+        res = execute_prepared_once(
+            conn, stmt_name, n_params, param_values, param_lengths, param_formats, result_format, opts);
+    }
+    return res;
+}
+
+PGresult* pgconn_execute_prepared_full_safe(pgconn_t* conn, const char* stmt_name, int n_params,
+                                            const char* const* param_values, const int* param_lengths,
+                                            const int* param_formats, int result_format,
+                                            const pgconn_query_opts_t* opts) {
+    if (!conn) return NULL;
+
+    if (conn->thread_safe) {
+        pthread_mutex_lock(&conn->lock);
+    }
+
+    PGresult* result = pgconn_execute_prepared_full(
+        conn, stmt_name, n_params, param_values, param_lengths, param_formats, result_format, opts);
+
+    if (conn->thread_safe) {
+        pthread_mutex_unlock(&conn->lock);
+    }
+
+    return result;
+}
+
+PGresult* pgconn_execute_prepared(pgconn_t* conn, const char* stmt_name, int n_params, const char* const* param_values,
+                                  const pgconn_query_opts_t* opts) {
+    // Simplified version: assumes all params are null-terminated text strings
+    // and result is requested as text.
+    return pgconn_execute_prepared_full(conn, stmt_name, n_params, param_values, NULL, NULL, 0, opts);
+}
+
+PGresult* pgconn_execute_prepared_safe(pgconn_t* conn, const char* stmt_name, int n_params,
+                                       const char* const* param_values, const pgconn_query_opts_t* opts) {
+    if (!conn) return NULL;
+
+    if (conn->thread_safe) {
+        pthread_mutex_lock(&conn->lock);
+    }
+
+    PGresult* result = pgconn_execute_prepared(conn, stmt_name, n_params, param_values, opts);
+
+    if (conn->thread_safe) {
+        pthread_mutex_unlock(&conn->lock);
+    }
+
+    return result;
+}
+
+bool pgconn_deallocate(pgconn_t* conn, const char* stmt_name) {
+    if (!conn || !conn->raw_conn || !stmt_name) {
+        set_error(conn, "Invalid connection or statement name");
+        return false;
+    }
+
+    set_error(conn, NULL);
+
+    // Build DEALLOCATE command
+    char query[512];
+    snprintf(query, sizeof(query), "DEALLOCATE %s", stmt_name);
+
+    bool result = pgconn_execute(conn, query, NULL);
+    if (result) {
+        unregister_prepared(conn, stmt_name);
+    }
+    return result;
+}
+
+bool pgconn_deallocate_safe(pgconn_t* conn, const char* stmt_name) {
+    if (!conn) return false;
+
+    if (conn->thread_safe) {
+        pthread_mutex_lock(&conn->lock);
+    }
+
+    bool result = pgconn_deallocate(conn, stmt_name);
+
+    if (conn->thread_safe) {
+        pthread_mutex_unlock(&conn->lock);
+    }
+
+    return result;
+}
+
+// === Statement Cache ===
+
+/** 64-bit FNV-1a hash of a string. */
+static uint64_t hash_sql(const char* sql) {
+    uint64_t hash = 14695981039346656037ULL;
+    for (const unsigned char* p = (const unsigned char*)sql; *p; p++) {
+        hash ^= *p;
+        hash *= 1099511628211ULL;
+    }
+    return hash;
+}
+
+/** Returns the configured cache capacity. */
+static inline int stmt_cache_capacity(const pgconn_t* conn) {
+    return conn->config.statement_cache_size > 0 ? conn->config.statement_cache_size : PGCONN_STMT_CACHE_SIZE;
+}
+
+/** Unlinks an entry from the LRU list. */
+static void lru_unlink(pgconn_t* conn, stmt_entry_t* entry) {
+    if (entry->lru_prev) {
+        entry->lru_prev->lru_next = entry->lru_next;
+    } else {
+        conn->stmt_lru_head = entry->lru_next;
+    }
+
+    if (entry->lru_next) {
+        entry->lru_next->lru_prev = entry->lru_prev;
+    } else {
+        conn->stmt_lru_tail = entry->lru_prev;
+    }
+
+    entry->lru_prev = NULL;
+    entry->lru_next = NULL;
+}
+
+/** Links an entry at the most recently used end. */
+static void lru_push_front(pgconn_t* conn, stmt_entry_t* entry) {
+    entry->lru_prev = NULL;
+    entry->lru_next = conn->stmt_lru_head;
+    if (conn->stmt_lru_head) {
+        conn->stmt_lru_head->lru_prev = entry;
+    } else {
+        conn->stmt_lru_tail = entry;
+    }
+    conn->stmt_lru_head = entry;
+}
+
+/** Finds a cached statement by query text. */
+static stmt_entry_t* stmt_cache_find(pgconn_t* conn, const char* sql, uint64_t hash) {
+    if (!conn->stmt_buckets) {
+        return NULL;
+    }
+
+    for (stmt_entry_t* e = conn->stmt_buckets[hash & conn->stmt_bucket_mask]; e; e = e->bucket_next) {
+        if (e->hash == hash && strcmp(e->sql, sql) == 0) {
+            return e;
+        }
+    }
+    return NULL;
+}
+
+/**
+ * Collects the result of a statement-cache command sent with a PQsend*()
+ * function, waiting at most timeout_ms (-1 = no limit).
+ */
+static PGresult* stmt_cache_result(pgconn_t* conn, int sent, int timeout_ms) {
+    if (sent != 1) {
+        set_error(conn, PQerrorMessage(conn->raw_conn));
+        return NULL;
+    }
+
+    if (!wait_for_result(conn, timeout_ms)) {
+        return NULL;
+    }
+
+    PGresult* res = PQgetResult(conn->raw_conn);
+    consume_results(conn);
+    return res;
+}
+
+/** Removes an entry from the cache, optionally deallocating it on the server. */
+static void stmt_cache_remove(pgconn_t* conn, stmt_entry_t* entry, bool deallocate, int timeout_ms) {
+    stmt_entry_t** link = &conn->stmt_buckets[entry->hash & conn->stmt_bucket_mask];
+    while (*link != entry) {
+        link = &(*link)->bucket_next;
+    }
+    *link = entry->bucket_next;
+
+    lru_unlink(conn, entry);
+    conn->stmt_count--;
+
+    if (deallocate) {
+        // Best effort: a failure only leaves the statement until the session ends
+#ifdef LIBPQ_HAS_CLOSE_PREPARED
+        int sent = PQsendClosePrepared(conn->raw_conn, entry->name);
+#else
+        char query[64];
+        snprintf(query, sizeof(query), "DEALLOCATE %s", entry->name);
+        int sent = PQsendQuery(conn->raw_conn, query);
+#endif
+        PQclear(stmt_cache_result(conn, sent, timeout_ms));
+    }
+
+    free(entry->sql);
+    free(entry);
+}
+
+/** Prepares a query under a generated name and adds it to the cache. */
+static stmt_entry_t* stmt_cache_add(pgconn_t* conn, const char* sql, uint64_t hash, int n_params, int timeout_ms) {
+    if (!conn->stmt_buckets) {
+        // Twice as many buckets as entries keeps chains short
+        size_t buckets = 1;
+        while (buckets < (size_t)stmt_cache_capacity(conn) * 2) {
+            buckets <<= 1;
+        }
+
+        conn->stmt_buckets = calloc(buckets, sizeof(stmt_entry_t*));
+        if (!conn->stmt_buckets) {
+            set_error(conn, "Memory allocation failed");
+            return NULL;
+        }
+        conn->stmt_bucket_mask = buckets - 1;
+    }
+
+    if (conn->stmt_count >= stmt_cache_capacity(conn)) {
+        stmt_cache_remove(conn, conn->stmt_lru_tail, true, timeout_ms);
+        if (!conn->raw_conn) {
+            return NULL;  // The DEALLOCATE timed out and the connection was closed
+        }
+        set_error(conn, NULL);
+    }
+
+    stmt_entry_t* entry = calloc(1, sizeof(stmt_entry_t));
+    if (!entry || !(entry->sql = strdup(sql))) {
+        free(entry);
+        set_error(conn, "Memory allocation failed");
+        return NULL;
+    }
+
+    entry->hash = hash;
+    snprintf(entry->name, sizeof(entry->name), "pgconn_stmt_%llu", (unsigned long long)++conn->stmt_seq);
+
+    PGresult* res = stmt_cache_result(
+        conn, PQsendPrepare(conn->raw_conn, entry->name, sql, n_params, NULL), timeout_ms);
+    if (!res || PQresultStatus(res) != PGRES_COMMAND_OK) {
+        if (res) {
+            set_result_error(conn, res);
+        } else if (conn->last_error[0] == '\0') {
+            set_error(conn, "No result received from prepare");
+        }
+        PQclear(res);
+        free(entry->sql);
+        free(entry);
+        return NULL;
+    }
+    PQclear(res);
+
+    size_t bucket                    = hash & conn->stmt_bucket_mask;
+    entry->bucket_next               = conn->stmt_buckets[bucket];
+    conn->stmt_buckets[bucket]       = entry;
+    lru_push_front(conn, entry);
+    conn->stmt_count++;
+
+    return entry;
+}
+
+/** Runs a query through the statement cache once, without recovery. */
+static PGresult* query_cached_once(pgconn_t* conn, const char* query, int n_params, const char* const* param_values,
+                                   const pgconn_query_opts_t* opts) {
+    if (!conn || !conn->raw_conn || !query) {
+        set_error(conn, "Invalid connection or query");
+        return NULL;
+    }
+
+    if (!check_session_idle(conn)) {
+        return NULL;
+    }
+
+    consume_results(conn);
+    set_error(conn, NULL);
+
+    uint64_t hash       = hash_sql(query);
+    stmt_entry_t* entry = stmt_cache_find(conn, query, hash);
+
+    if (entry) {
+        lru_unlink(conn, entry);
+        lru_push_front(conn, entry);
+
+        PGresult* res = execute_prepared_once(conn, entry->name, n_params, param_values, NULL, NULL, 0, opts);
+        if (res || strcmp(conn->last_sqlstate, "26000") != 0) {
+            return res;
+        }
+
+        // The statement vanished behind our back (DEALLOCATE ALL, DISCARD ALL):
+        // forget it and prepare again.
+        stmt_cache_remove(conn, entry, false, opts->timeout_ms);
+        set_error(conn, NULL);
+    }
+
+    entry = stmt_cache_add(conn, query, hash, n_params, opts->timeout_ms);
+    if (!entry) {
+        return NULL;
+    }
+
+    return execute_prepared_once(conn, entry->name, n_params, param_values, NULL, NULL, 0, opts);
+}
+
+PGresult* pgconn_query_cached(pgconn_t* conn, const char* query, int n_params, const char* const* param_values,
+                              const pgconn_query_opts_t* opts) {
+    if (!opts) {
+        opts = &DEFAULT_QUERY_OPTS;
+    }
+
+    // After a reconnect the cache is empty, so the retry prepares the query afresh
+    bool in_transaction;
+    if (!begin_recoverable(conn, &in_transaction)) {
+        return NULL;
+    }
+
+    PGresult* res = query_cached_once(conn, query, n_params, param_values, opts);
+    if (!res && recover_connection(conn, opts, in_transaction)) {
+        res = query_cached_once(conn, query, n_params, param_values, opts);
+    }
+    return res;
+}
+
+PGresult* pgconn_query_cached_safe(pgconn_t* conn, const char* query, int n_params, const char* const* param_values,
+                                   const pgconn_query_opts_t* opts) {
+    if (!conn) return NULL;
+
+    if (conn->thread_safe) {
+        pthread_mutex_lock(&conn->lock);
+    }
+
+    PGresult* result = pgconn_query_cached(conn, query, n_params, param_values, opts);
+
+    if (conn->thread_safe) {
+        pthread_mutex_unlock(&conn->lock);
+    }
+
+    return result;
+}
+
+// === Pipeline Mode ===
+
+#ifdef LIBPQ_HAS_PIPELINING
+
+/** Checks that the connection is usable and in pipeline mode. */
+static bool check_pipeline(pgconn_t* conn) {
+    if (!conn || !conn->raw_conn) {
+        set_error(conn, "Invalid connection");
+        return false;
+    }
+
+    if (PQpipelineStatus(conn->raw_conn) == PQ_PIPELINE_OFF) {
+        set_error(conn, "Connection is not in pipeline mode");
+        return false;
+    }
+
+    return true;
+}
+
+/**
+ * Pushes queued pipeline output to the server without blocking and reads
+ * whatever results it has sent back meanwhile. A large batch therefore never
+ * fills both the client's send buffer and the server's output buffer, which
+ * would deadlock the two sides. Unread results are buffered by libpq.
+ */
+static bool pipeline_pump(pgconn_t* conn) {
+    if (PQflush(conn->raw_conn) < 0 || PQconsumeInput(conn->raw_conn) == 0) {
+        set_error(conn, PQerrorMessage(conn->raw_conn));
+        return false;
+    }
+    return true;
+}
+
+bool pgconn_pipeline_begin(pgconn_t* conn) {
+    if (!conn || !conn->raw_conn) {
+        set_error(conn, "Invalid connection");
+        return false;
+    }
+
+    if (!check_session_idle(conn)) {
+        return false;
+    }
+
+    consume_results(conn);
+    set_error(conn, NULL);
+
+    // Synchronous prepares are not allowed once the pipeline is entered
+    ensure_prepared(conn);
+
+    if (PQenterPipelineMode(conn->raw_conn) != 1) {
+        set_error(conn, PQerrorMessage(conn->raw_conn));
+        return false;
+    }
+
+    // Sends must not block while the server waits for us to read its results
+    if (PQsetnonblocking(conn->raw_conn, 1) != 0) {
+        set_error(conn, PQerrorMessage(conn->raw_conn));
+        PQexitPipelineMode(conn->raw_conn);
+        return false;
+    }
+
+    conn->pipeline_queued = 0;
+    conn->pipeline_syncs  = 0;
+    return true;
+}
+
+bool pgconn_pipeline_end(pgconn_t* conn) {
+    if (!check_pipeline(conn)) {
+        return false;
+    }
+
+    if (conn->pipeline_queued > 0 || conn->pipeline_syncs > 0) {
+        set_error(conn, "Pipeline still has unread results");
+        return false;
+    }
+
+    if (PQexitPipelineMode(conn->raw_conn) != 1) {
+        set_error(conn, PQerrorMessage(conn->raw_conn));
+        return false;
+    }
+
+    PQsetnonblocking(conn->raw_conn, 0);
+    return true;
+}
+
+bool pgconn_pipeline_send_query(pgconn_t* conn, const char* query) {
+    // The simple query protocol is not allowed in pipeline mode
+    return pgconn_pipeline_send_query_params(conn, query, 0, NULL, NULL, NULL, NULL, 0);
+}
+
+bool pgconn_pipeline_send_query_params(pgconn_t* conn, const char* query, int n_params, const Oid* param_types,
+                                       const char* const* param_values, const int* param_lengths,
+                                       const int* param_formats, int result_format) {
+    if (!check_pipeline(conn)) {
+        return false;
+    }
+
+    if (!query) {
+        set_error(conn, "Invalid query");
+        return false;
+    }
+
+    if (n_params < 0) n_params = 0;
+
+    if (PQsendQueryParams(
+            conn->raw_conn, query, n_params, param_types, param_values, param_lengths, param_formats, result_format) !=
+        1) {
+        set_error(conn, PQerrorMessage(conn->raw_conn));
+        return false;
+    }
+
+    conn->pipeline_queued++;
+    return pipeline_pump(conn);
+}
+
+bool pgconn_pipeline_send_prepare(pgconn_t* conn, const char* stmt_name, const char* query, int n_params,
+                                  const Oid* param_types) {
+    if (!check_pipeline(conn)) {
+        return false;
+    }
+
+    if (!stmt_name || !query) {
+        set_error(conn, "Invalid statement name or query");
+        return false;
+    }
+
+    if (PQsendPrepare(conn->raw_conn, stmt_name, query, n_params, param_types) != 1) {
+        set_error(conn, PQerrorMessage(conn->raw_conn));
+        return false;
+    }
+
+    // Registered optimistically; if the prepare fails, re-preparing it later fails harmlessly too
+    register_prepared(conn, stmt_name, query, n_params, param_types);
+
+    conn->pipeline_queued++;
+    return pipeline_pump(conn);
+}
+
+bool pgconn_pipeline_send_prepared(pgconn_t* conn, const char* stmt_name, int n_params,
+                                   const char* const* param_values, const int* param_lengths,
+                                   const int* param_formats, int result_format) {
+    if (!check_pipeline(conn)) {
+        return false;
+    }
+
+    if (!stmt_name) {
+        set_error(conn, "Invalid statement name");
+        return false;
+    }
+
+    if (PQsendQueryPrepared(
+            conn->raw_conn, stmt_name, n_params, param_values, param_lengths, param_formats, result_format) != 1) {
+        set_error(conn, PQerrorMessage(conn->raw_conn));
+        return false;
+    }
+
+    conn->pipeline_queued++;
+    return pipeline_pump(conn);
+}
+
+bool pgconn_pipeline_sync(pgconn_t* conn) {
+    if (!check_pipeline(conn)) {
+        return false;
+    }
+
+    if (PQpipelineSync(conn->raw_conn) != 1) {
+        set_error(conn, PQerrorMessage(conn->raw_conn));
+        return false;
+    }
+
+    conn->pipeline_syncs++;
+    return pipeline_pump(conn);
+}
+
+PGresult* pgconn_pipeline_next_result(pgconn_t* conn, const pgconn_query_opts_t* opts) {
+    if (!check_pipeline(conn)) {
+        return NULL;
+    }
+
+    if (!opts) {
+        opts = &DEFAULT_QUERY_OPTS;
+    }
+
+    if (conn->pipeline_syncs == 0) {
+        // Queries after the last sync point have not been flushed to the server
+        if (conn->pipeline_queued > 0) {
+            set_error(conn, "pgconn_pipeline_sync() must be called before reading results");
+        }
+        return NULL;
+    }
+
+    while (true) {
+        if (PQisBusy(conn->raw_conn) && !wait_for_result(conn, opts->timeout_ms)) {
+            return NULL;
+        }
+
+        PGresult* res = PQgetResult(conn->raw_conn);
+        if (!res) {
+            if (PQstatus(conn->raw_conn) == CONNECTION_BAD) {
+                set_error(conn, PQerrorMessage(conn->raw_conn));
+                return NULL;
+            }
+            continue;  // End of one query's results; the next query follows
+        }
+
+        ExecStatusType status = PQresultStatus(res);
+        if (status == PGRES_PIPELINE_SYNC) {
+            PQclear(res);
+            conn->pipeline_syncs--;
+            update_activity(conn);
+
+            if (conn->pipeline_syncs == 0) {
+                return NULL;
+            }
+            continue;
+        }
+
+        conn->pipeline_queued--;
+        if (status == PGRES_PIPELINE_ABORTED) {
+            set_error(conn, "Query skipped after an earlier error in the pipeline");
+        } else if (status != PGRES_COMMAND_OK && status != PGRES_TUPLES_OK) {
+            set_result_error(conn, res);
+        }
+
+        update_activity(conn);
+        return res;
+    }
+}
+
+#else  // !LIBPQ_HAS_PIPELINING
+
+#define PIPELINE_UNSUPPORTED "Pipeline mode requires libpq 14 or newer"
+
+bool pgconn_pipeline_begin(pgconn_t* conn) {
+    set_error(conn, PIPELINE_UNSUPPORTED);
+    return false;
+}
+
+bool pgconn_pipeline_end(pgconn_t* conn) {
+    set_error(conn, PIPELINE_UNSUPPORTED);
+    return false;
+}
+
+bool pgconn_pipeline_send_query(pgconn_t* conn, const char* query) {
+    (void)query;
+    set_error(conn, PIPELINE_UNSUPPORTED);
+    return false;
+}
+
+bool pgconn_pipeline_send_query_params(pgconn_t* conn, const char* query, int n_params, const Oid* param_types,
+                                       const char* const* param_values, const int* param_lengths,
+                                       const int* param_formats, int result_format) {
+    (void)query, (void)n_params, (void)param_types, (void)param_values;
+    (void)param_lengths, (void)param_formats, (void)result_format;
+    set_error(conn, PIPELINE_UNSUPPORTED);
+    return false;
+}
+
+bool pgconn_pipeline_send_prepare(pgconn_t* conn, const char* stmt_name, const char* query, int n_params,
+                                  const Oid* param_types) {
+    (void)stmt_name, (void)query, (void)n_params, (void)param_types;
+    set_error(conn, PIPELINE_UNSUPPORTED);
+    return false;
+}
+
+bool pgconn_pipeline_send_prepared(pgconn_t* conn, const char* stmt_name, int n_params,
+                                   const char* const* param_values, const int* param_lengths,
+                                   const int* param_formats, int result_format) {
+    (void)stmt_name, (void)n_params, (void)param_values;
+    (void)param_lengths, (void)param_formats, (void)result_format;
+    set_error(conn, PIPELINE_UNSUPPORTED);
+    return false;
+}
+
+bool pgconn_pipeline_sync(pgconn_t* conn) {
+    set_error(conn, PIPELINE_UNSUPPORTED);
+    return false;
+}
+
+PGresult* pgconn_pipeline_next_result(pgconn_t* conn, const pgconn_query_opts_t* opts) {
+    (void)opts;
+    set_error(conn, PIPELINE_UNSUPPORTED);
+    return NULL;
+}
+
+#endif  // LIBPQ_HAS_PIPELINING
+
+int pgconn_pipeline_pending(pgconn_t* conn) {
+    return conn ? conn->pipeline_queued : 0;
+}
+
+// === COPY FROM STDIN ===
+
+// Signature, flags field and header extension length of the binary COPY format
+static const char COPY_BINARY_HEADER[19] = "PGCOPY\n\377\r\n\0\0\0\0\0\0\0\0\0";
+
+/** Builds "COPY <target> <direction> WITH (FORMAT <format>)". Caller frees. */
+static char* build_copy_sql(const char* target, const char* direction, pgconn_copy_format_t format) {
+    const char* format_name = format == PGCONN_COPY_CSV ? "csv" : format == PGCONN_COPY_BINARY ? "binary" : "text";
+
+    int len   = snprintf(NULL, 0, "COPY %s %s WITH (FORMAT %s)", target, direction, format_name);
+    char* sql = malloc((size_t)len + 1);
+    if (sql) {
+        snprintf(sql, (size_t)len + 1, "COPY %s %s WITH (FORMAT %s)", target, direction, format_name);
+    }
+    return sql;
+}
+
+/** Ensures copy_buf can hold `extra` more bytes. */
+static bool copy_reserve(pgconn_t* conn, size_t extra) {
+    if (conn->copy_len + extra <= conn->copy_cap) {
+        return true;
+    }
+
+    size_t cap = conn->copy_cap ? conn->copy_cap : PGCONN_COPY_FLUSH_SIZE;
+    while (cap < conn->copy_len + extra) {
+        cap *= 2;
+    }
+
+    char* buf = realloc(conn->copy_buf, cap);
+    if (!buf) {
+        set_error(conn, "Memory allocation failed");
+        return false;
+    }
+
+    conn->copy_buf = buf;
+    conn->copy_cap = cap;
+    return true;
+}
+
+/** Appends raw bytes to copy_buf. Space must have been reserved. */
+static inline void copy_append(pgconn_t* conn, const void* data, size_t len) {
+    memcpy(conn->copy_buf + conn->copy_len, data, len);
+    conn->copy_len += len;
+}
+
+/** Appends a big-endian integer of `size` bytes to copy_buf. Space must have been reserved. */
+static inline void copy_append_be(pgconn_t* conn, uint32_t value, size_t size) {
+    for (size_t i = size; i-- > 0;) {
+        conn->copy_buf[conn->copy_len++] = (char)((value >> (8 * i)) & 0xff);
+    }
+}
+
+/**
+ * Sends everything in copy_buf to the server. The connection is nonblocking
+ * during COPY IN, where libpq would queue data without limit, so the queue is
+ * flushed here and waits for the server to read at most op_timeout_ms.
+ */
+static bool copy_flush(pgconn_t* conn) {
+    if (conn->copy_len == 0) {
+        return true;
+    }
+
+    if (PQputCopyData(conn->raw_conn, conn->copy_buf, (int)conn->copy_len) != 1) {
+        set_error(conn, PQerrorMessage(conn->raw_conn));
+        return false;
+    }
+    conn->copy_len = 0;
+
+    return wait_for_output(conn, conn->op_timeout_ms);
+}
+
+/** Checks whether a timeout cancelled the COPY IN or closed its connection. */
+static bool copy_in_lost(pgconn_t* conn) {
+    return !conn->raw_conn || PQtransactionStatus(conn->raw_conn) != PQTRANS_ACTIVE;
+}
+
+/** Leaves COPY IN state and puts the connection back in blocking mode. */
+static void end_copy_in(pgconn_t* conn) {
+    conn->copy_in_active = false;
+    conn->copy_len       = 0;
+    if (conn->raw_conn) {
+        PQsetnonblocking(conn->raw_conn, 0);
+    }
+}
+
+/** Appends one text-format field, escaping backslash and control characters. */
+static bool copy_put_text_field(pgconn_t* conn, const char* value, size_t len) {
+    if (!value) {
+        if (!copy_reserve(conn, 2)) return false;
+        copy_append(conn, "\\N", 2);
+        return true;
+    }
+
+    // Worst case every byte needs a backslash
+    if (!copy_reserve(conn, len * 2)) return false;
+
+    for (size_t i = 0; i < len; i++) {
+        char c = value[i];
+        switch (c) {
+            case '\\':
+                copy_append(conn, "\\\\", 2);
+                break;
+            case '\t':
+                copy_append(conn, "\\t", 2);
+                break;
+            case '\n':
+                copy_append(conn, "\\n", 2);
+                break;
+            case '\r':
+                copy_append(conn, "\\r", 2);
+                break;
+            default:
+                conn->copy_buf[conn->copy_len++] = c;
+                break;
+        }
+    }
+
+    return true;
+}
+
+/** Appends one CSV field, quoting it when needed to round-trip exactly. */
+static bool copy_put_csv_field(pgconn_t* conn, const char* value, size_t len) {
+    if (!value) {
+        return true;  // NULL is an unquoted empty field
+    }
+
+    // Empty strings and a lone \. must be quoted to differ from NULL and end-of-data
+    bool quote = (len == 0) || (len == 2 && value[0] == '\\' && value[1] == '.');
+    for (size_t i = 0; i < len && !quote; i++) {
+        char c = value[i];
+        quote  = (c == ',' || c == '"' || c == '\n' || c == '\r');
+    }
+
+    if (!quote) {
+        if (!copy_reserve(conn, len)) return false;
+        copy_append(conn, value, len);
+        return true;
+    }
+
+    // Worst case every byte is a doubled quote, plus the surrounding quotes
+    if (!copy_reserve(conn, len * 2 + 2)) return false;
+
+    conn->copy_buf[conn->copy_len++] = '"';
+    for (size_t i = 0; i < len; i++) {
+        if (value[i] == '"') {
+            conn->copy_buf[conn->copy_len++] = '"';
+        }
+        conn->copy_buf[conn->copy_len++] = value[i];
+    }
+    conn->copy_buf[conn->copy_len++] = '"';
+
+    return true;
+}
+
+bool pgconn_copy_in_begin(pgconn_t* conn, const char* target, pgconn_copy_format_t format,
+                          const pgconn_query_opts_t* opts) {
+    if (!conn || !conn->raw_conn || !target) {
+        set_error(conn, "Invalid connection or COPY target");
+        return false;
+    }
+
+    if (!opts) {
+        opts = &DEFAULT_QUERY_OPTS;
+    }
+
+    if (!check_session_idle(conn)) {
+        return false;
+    }
+
+    consume_results(conn);
+    set_error(conn, NULL);
+
+    char* sql = build_copy_sql(target, "FROM STDIN", format);
+    if (!sql) {
+        set_error(conn, "Memory allocation failed");
+        return false;
+    }
+
+    int sent = PQsendQuery(conn->raw_conn, sql);
+    free(sql);
+
+    if (sent != 1) {
+        set_error(conn, PQerrorMessage(conn->raw_conn));
+        return false;
+    }
+
+    if (!wait_for_result(conn, opts->timeout_ms)) {
+        return false;
+    }
+
+    PGresult* res = PQgetResult(conn->raw_conn);
+    if (!res) {
+        set_error(conn, "No result received from COPY");
+        return false;
+    }
+
+    if (PQresultStatus(res) != PGRES_COPY_IN) {
+        set_result_error(conn, res);
+        PQclear(res);
+        consume_results(conn);
+        return false;
+    }
+    PQclear(res);
+
+    // Rows are queued without blocking so that each flush can honour the timeout
+    if (PQsetnonblocking(conn->raw_conn, 1) != 0) {
+        set_error(conn, PQerrorMessage(conn->raw_conn));
+        PQputCopyEnd(conn->raw_conn, "client failed to start COPY");
+        consume_results(conn);
+        return false;
+    }
+
+    conn->copy_in_active  = true;
+    conn->copy_format     = format;
+    conn->op_timeout_ms   = opts->timeout_ms;
+    conn->copy_len        = 0;
+
+    if (format == PGCONN_COPY_BINARY) {
+        if (!copy_reserve(conn, sizeof(COPY_BINARY_HEADER))) {
+            pgconn_copy_in_abort(conn, "out of memory");
+            set_error(conn, "Memory allocation failed");
+            return false;
+        }
+        copy_append(conn, COPY_BINARY_HEADER, sizeof(COPY_BINARY_HEADER));
+    }
+
+    update_activity(conn);
+    return true;
+}
+
+bool pgconn_copy_in_put_row(pgconn_t* conn, int n_fields, const char* const* values, const int* lengths) {
+    if (!conn || !conn->copy_in_active) {
+        set_error(conn, "No COPY FROM STDIN in progress");
+        return false;
+    }
+
+    if (copy_in_lost(conn)) {
+        end_copy_in(conn);  // The timeout error says why
+        return false;
+    }
+
+    // Binary rows carry a 16-bit field count
+    if (n_fields < 0 || (n_fields > 0 && !values) ||
+        (conn->copy_format == PGCONN_COPY_BINARY && n_fields > INT16_MAX)) {
+        set_error(conn, "Invalid row");
+        return false;
+    }
+
+    if (conn->copy_format == PGCONN_COPY_BINARY && n_fields > 0 && !lengths) {
+        set_error(conn, "Binary COPY requires field lengths");
+        return false;
+    }
+
+    // Validate before appending anything, so a rejected row leaves no partial data behind
+    for (int i = 0; lengths && i < n_fields; i++) {
+        if (values[i] && lengths[i] < 0) {
+            set_error(conn, "Invalid row");
+            return false;
+        }
+    }
+
+    if (conn->copy_format == PGCONN_COPY_BINARY) {
+        if (!copy_reserve(conn, 2)) return false;
+        copy_append_be(conn, (uint32_t)n_fields, 2);
+
+        for (int i = 0; i < n_fields; i++) {
+            if (!values[i]) {
+                if (!copy_reserve(conn, 4)) return false;
+                copy_append_be(conn, UINT32_MAX, 4);  // -1 marks NULL
+                continue;
+            }
+
+            size_t len = (size_t)lengths[i];
+            if (!copy_reserve(conn, 4 + len)) return false;
+            copy_append_be(conn, (uint32_t)len, 4);
+            copy_append(conn, values[i], len);
+        }
+    } else {
+        char delimiter = conn->copy_format == PGCONN_COPY_CSV ? ',' : '\t';
+
+        for (int i = 0; i < n_fields; i++) {
+            if (i > 0) {
+                if (!copy_reserve(conn, 1)) return false;
+                conn->copy_buf[conn->copy_len++] = delimiter;
+            }
+
+            size_t len = 0;
+            if (values[i]) {
+                len = lengths ? (size_t)lengths[i] : strlen(values[i]);
+            }
+
+            bool ok = conn->copy_format == PGCONN_COPY_CSV ? copy_put_csv_field(conn, values[i], len)
+                                                           : copy_put_text_field(conn, values[i], len);
+            if (!ok) return false;
+        }
+
+        if (!copy_reserve(conn, 1)) return false;
+        conn->copy_buf[conn->copy_len++] = '\n';
+    }
+
+    if (conn->copy_len >= PGCONN_COPY_FLUSH_SIZE) {
+        return copy_flush(conn);
+    }
+
+    return true;
+}
+
+/** Ends COPY IN with an optional error message and collects the final result. */
+static bool finish_copy_in(pgconn_t* conn, const char* error_message, int64_t* rows_copied) {
+    if (PQputCopyEnd(conn->raw_conn, error_message) != 1) {
+        set_error(conn, PQerrorMessage(conn->raw_conn));
+        end_copy_in(conn);
+        return false;
+    }
+
+    // wait_for_result() also flushes what is still queued
+    bool done = wait_for_result(conn, conn->op_timeout_ms);
+    end_copy_in(conn);
+    if (!done) {
+        return false;
+    }
+
+    PGresult* res = PQgetResult(conn->raw_conn);
+    if (!res) {
+        set_error(conn, "No result received from COPY");
+        return false;
+    }
+
+    bool success = (PQresultStatus(res) == PGRES_COMMAND_OK);
+    if (!success) {
+        set_result_error(conn, res);
+    } else if (rows_copied) {
+        *rows_copied = strtoll(PQcmdTuples(res), NULL, 10);
+    }
+
+    PQclear(res);
+    consume_results(conn);
+    update_activity(conn);
+
+    return success;
+}
+
+bool pgconn_copy_in_end(pgconn_t* conn, int64_t* rows_copied) {
+    if (!conn || !conn->copy_in_active) {
+        set_error(conn, "No COPY FROM STDIN in progress");
+        return false;
+    }
+
+    if (copy_in_lost(conn)) {
+        // A timeout cancelled the COPY or closed the connection; the error says why
+        end_copy_in(conn);
+        return false;
+    }
+
+    if (conn->copy_format == PGCONN_COPY_BINARY) {
+        if (!copy_reserve(conn, 2)) {
+            finish_copy_in(conn, "out of memory", NULL);
+            set_error(conn, "Memory allocation failed");
+            return false;
+        }
+        copy_append_be(conn, 0xffff, 2);  // File trailer: field count of -1
+    }
+
+    if (!copy_flush(conn)) {
+        if (copy_in_lost(conn)) {
+            end_copy_in(conn);  // Keep the timeout error
+        } else {
+            conn->copy_len = 0;
+            finish_copy_in(conn, "client failed to send COPY data", NULL);
+        }
+        return false;
+    }
+
+    return finish_copy_in(conn, NULL, rows_copied);
+}
+
+bool pgconn_copy_in_abort(pgconn_t* conn, const char* reason) {
+    if (!conn || !conn->copy_in_active) {
+        set_error(conn, "No COPY FROM STDIN in progress");
+        return false;
+    }
+
+    if (copy_in_lost(conn)) {
+        // A timeout cancelled the COPY or closed the connection; the error says why
+        end_copy_in(conn);
+        return false;
+    }
+
+    conn->copy_len = 0;
+    finish_copy_in(conn, reason ? reason : "COPY aborted by client", NULL);
+
+    // The server answers an aborted COPY with an error, which is the expected outcome
+    bool idle = conn->raw_conn && PQtransactionStatus(conn->raw_conn) != PQTRANS_ACTIVE;
+    if (idle) {
+        set_error(conn, NULL);
+    }
+    return idle;
+}
+
+// === COPY TO STDOUT ===
+
+/** Reads a big-endian integer of `size` bytes. */
+static inline uint32_t read_be(const unsigned char* p, size_t size) {
+    uint32_t value = 0;
+    for (size_t i = 0; i < size; i++) {
+        value = (value << 8) | p[i];
+    }
+    return value;
+}
+
+/** Releases the chunk returned by the previous PQgetCopyData() call. */
+static void free_copy_chunk(pgconn_t* conn) {
+    if (conn->copy_chunk) {
+        PQfreemem(conn->copy_chunk);
+        conn->copy_chunk = NULL;
+    }
+}
+
+/** Collects the final result once PQgetCopyData() reports the end of data. */
+static bool finish_copy_out(pgconn_t* conn) {
+    conn->copy_out_done = true;
+
+    if (PQisBusy(conn->raw_conn) && !wait_for_result(conn, conn->op_timeout_ms)) {
+        return false;
+    }
+
+    PGresult* res = PQgetResult(conn->raw_conn);
+    if (!res) {
+        set_error(conn, "No result received from COPY");
+        return false;
+    }
+
+    bool success = (PQresultStatus(res) == PGRES_COMMAND_OK);
+    if (!success) {
+        set_result_error(conn, res);
+    }
+
+    PQclear(res);
+    consume_results(conn);
+    update_activity(conn);
+
+    return success;
+}
+
+bool pgconn_copy_out_begin(pgconn_t* conn, const char* source, pgconn_copy_format_t format,
+                           const pgconn_query_opts_t* opts) {
+    if (!conn || !conn->raw_conn || !source) {
+        set_error(conn, "Invalid connection or COPY source");
+        return false;
+    }
+
+    if (!opts) {
+        opts = &DEFAULT_QUERY_OPTS;
+    }
+
+    if (!check_session_idle(conn)) {
+        return false;
+    }
+
+    consume_results(conn);
+    set_error(conn, NULL);
+
+    char* sql = build_copy_sql(source, "TO STDOUT", format);
+    if (!sql) {
+        set_error(conn, "Memory allocation failed");
+        return false;
+    }
+
+    int sent = PQsendQuery(conn->raw_conn, sql);
+    free(sql);
+
+    if (sent != 1) {
+        set_error(conn, PQerrorMessage(conn->raw_conn));
+        return false;
+    }
+
+    if (!wait_for_result(conn, opts->timeout_ms)) {
+        return false;
+    }
+
+    PGresult* res = PQgetResult(conn->raw_conn);
+    if (!res) {
+        set_error(conn, "No result received from COPY");
+        return false;
+    }
+
+    if (PQresultStatus(res) != PGRES_COPY_OUT) {
+        set_result_error(conn, res);
+        PQclear(res);
+        consume_results(conn);
+        return false;
+    }
+    PQclear(res);
+
+    conn->copy_out_active = true;
+    conn->copy_out_done   = false;
+    conn->copy_out_header = (format == PGCONN_COPY_BINARY);
+    conn->copy_format     = format;
+    conn->op_timeout_ms   = opts->timeout_ms;
+
+    update_activity(conn);
+    return true;
+}
+
+int pgconn_copy_out_next(pgconn_t* conn, const char** data, size_t* len) {
+    if (!conn || !conn->raw_conn || !conn->copy_out_active) {
+        set_error(conn, "No COPY TO STDOUT in progress");
+        return -1;
+    }
+
+    if (!data || !len) {
+        set_error(conn, "Invalid output pointers");
+        return -1;
+    }
+
+    free_copy_chunk(conn);
+    *data = NULL;
+    *len  = 0;
+
+    if (conn->copy_out_done) {
+        return 0;
+    }
+
+    while (true) {
+        char* buf = NULL;
+        int n     = PQgetCopyData(conn->raw_conn, &buf, 1);
+
+        if (n > 0) {
+            conn->copy_chunk = buf;
+            *data            = buf;
+            *len             = (size_t)n;
+            return 1;
+        }
+
+        if (n == 0) {
+            // Partial row buffered; wait for more data without blocking forever
+            if (!wait_for_copy_data(conn, conn->op_timeout_ms)) {
+                return -1;
+            }
+            continue;
+        }
+
+        if (n == -1) {
+            return finish_copy_out(conn) ? 0 : -1;
+        }
+
+        set_error(conn, PQerrorMessage(conn->raw_conn));
+        return -1;
+    }
+}
+
+int pgconn_copy_out_next_tuple(pgconn_t* conn, pgconn_copy_tuple_t* tuple) {
+    if (!conn || !tuple) {
+        set_error(conn, "Invalid connection or tuple");
+        return -1;
+    }
+
+    if (conn->copy_format != PGCONN_COPY_BINARY) {
+        set_error(conn, "Decoded tuples require PGCONN_COPY_BINARY");
+        return -1;
+    }
+
+    while (true) {
+        const char* data;
+        size_t len;
+        int rc = pgconn_copy_out_next(conn, &data, &len);
+        if (rc <= 0) {
+            return rc;
+        }
+
+        const unsigned char* p   = (const unsigned char*)data;
+        const unsigned char* end = p + len;
+
+        // The first chunk starts with the file header
+        if (conn->copy_out_header) {
+            if (len < sizeof(COPY_BINARY_HEADER) || memcmp(p, COPY_BINARY_HEADER, 11) != 0) {
+                set_error(conn, "Invalid binary COPY header");
+                return -1;
+            }
+
+            uint32_t ext_len = read_be(p + 15, 4);
+            if (ext_len > len - sizeof(COPY_BINARY_HEADER)) {
+                set_error(conn, "Invalid binary COPY header");
+                return -1;
+            }
+
+            p += sizeof(COPY_BINARY_HEADER) + ext_len;
+            conn->copy_out_header = false;
+        }
+
+        if (end - p < 2) {
+            set_error(conn, "Truncated binary COPY row");
+            return -1;
+        }
+
+        uint32_t n_fields = read_be(p, 2);
+        p += 2;
+
+        if (n_fields == 0xffff) {
+            continue;  // File trailer; the next read reports completion
+        }
+
+        if ((int)n_fields > conn->copy_fields_cap) {
+            const char** values = realloc(conn->copy_values, n_fields * sizeof(*values));
+            if (values) conn->copy_values = values;
+
+            int* lengths = realloc(conn->copy_lengths, n_fields * sizeof(*lengths));
+            if (lengths) conn->copy_lengths = lengths;
+
+            if (!values || !lengths) {
+                set_error(conn, "Memory allocation failed");
+                return -1;
+            }
+            conn->copy_fields_cap = (int)n_fields;
+        }
+
+        for (uint32_t i = 0; i < n_fields; i++) {
+            if (end - p < 4) {
+                set_error(conn, "Truncated binary COPY row");
+                return -1;
+            }
+
+            int32_t field_len = (int32_t)read_be(p, 4);
+            p += 4;
+
+            if (field_len < 0) {
+                conn->copy_values[i]  = NULL;
+                conn->copy_lengths[i] = -1;
+                continue;
+            }
+
+            if (end - p < field_len) {
+                set_error(conn, "Truncated binary COPY row");
+                return -1;
+            }
+
+            conn->copy_values[i]  = (const char*)p;
+            conn->copy_lengths[i] = field_len;
+            p += field_len;
+        }
+
+        tuple->n_fields = (int)n_fields;
+        tuple->values   = conn->copy_values;
+        tuple->lengths  = conn->copy_lengths;
+        return 1;
+    }
+}
+
+bool pgconn_copy_out_end(pgconn_t* conn) {
+    if (!conn || !conn->copy_out_active) {
+        set_error(conn, "No COPY TO STDOUT in progress");
+        return false;
+    }
+
+    free_copy_chunk(conn);
+    conn->copy_out_active = false;
+
+    if (conn->copy_out_done) {
+        return conn->last_error[0] == '\0';
+    }
+
+    // Stopped early: cancel the query and discard whatever is still in flight
+    // (unless a timeout already closed the connection)
+    if (conn->raw_conn) {
+        cancel_and_drain(conn);
+    }
+
+    // Keep the original error if the COPY stopped because of a failure
+    if (conn->last_error[0] == '\0') {
+        set_error(conn, "COPY TO STDOUT stopped before completion");
+    }
+    return false;
+}
+
+bool pgconn_copy_out(pgconn_t* conn, const char* source, pgconn_copy_format_t format, pgconn_copy_chunk_fn fn,
+                     void* user_data, const pgconn_query_opts_t* opts) {
+    if (!fn) {
+        set_error(conn, "Invalid COPY callback");
+        return false;
+    }
+
+    if (!pgconn_copy_out_begin(conn, source, format, opts)) {
+        return false;
+    }
+
+    const char* data;
+    size_t len;
+    int rc;
+    while ((rc = pgconn_copy_out_next(conn, &data, &len)) > 0) {
+        if (!fn(data, len, user_data)) {
+            break;
+        }
+    }
+
+    return pgconn_copy_out_end(conn) && rc == 0;
+}
+
+bool pgconn_copy_out_tuples(pgconn_t* conn, const char* source, pgconn_copy_tuple_fn fn, void* user_data,
+                            const pgconn_query_opts_t* opts) {
+    if (!fn) {
+        set_error(conn, "Invalid COPY callback");
+        return false;
+    }
+
+    if (!pgconn_copy_out_begin(conn, source, PGCONN_COPY_BINARY, opts)) {
+        return false;
+    }
+
+    pgconn_copy_tuple_t tuple;
+    int rc;
+    while ((rc = pgconn_copy_out_next_tuple(conn, &tuple)) > 0) {
+        if (!fn(&tuple, user_data)) {
+            break;
+        }
+    }
+
+    return pgconn_copy_out_end(conn) && rc == 0;
+}
 
-    if (conn->thread_safe) {
-        pthread_mutex_unlock(&conn->lock);
+// === Streaming Queries ===
+
+bool pgconn_stream_begin_full(pgconn_t* conn, const char* query, int n_params, const Oid* param_types,
+                              const char* const* param_values, const int* param_lengths, const int* param_formats,
+                              int result_format, int chunk_size, const pgconn_query_opts_t* opts) {
+    if (!conn || !conn->raw_conn || !query) {
+        set_error(conn, "Invalid connection or query");
+        return false;
     }
 
-    return result;
-}
+    if (!opts) {
+        opts = &DEFAULT_QUERY_OPTS;
+    }
 
-// === Prepared Statements ===
+    if (n_params < 0) n_params = 0;
 
-bool pgconn_prepare(pgconn_t* conn, const char* stmt_name, const char* query, int n_params, const Oid* param_types) {
-    if (!conn || !conn->raw_conn || !stmt_name || !query) {
-        set_error(conn, "Invalid connection, statement name, or query");
+    if (!check_session_idle(conn)) {
         return false;
     }
 
     consume_results(conn);
     set_error(conn, NULL);
 
-    PGresult* res = PQprepare(conn->raw_conn, stmt_name, query, n_params, param_types);
-    if (!res) {
-        set_error(conn, "No result received from prepare");
+    if (PQsendQueryParams(
+            conn->raw_conn, query, n_params, param_types, param_values, param_lengths, param_formats, result_format) !=
+        1) {
+        set_error(conn, PQerrorMessage(conn->raw_conn));
         return false;
     }
 
-    bool success = (PQresultStatus(res) == PGRES_COMMAND_OK);
-    if (!success) {
-        set_error(conn, PQresultErrorMessage(res));
+    // The row mode must be chosen right after sending, before any result is read
+    int mode_set;
+#ifdef LIBPQ_HAS_CHUNK_MODE
+    if (chunk_size > 1) {
+        mode_set = PQsetChunkedRowsMode(conn->raw_conn, chunk_size);
+    } else {
+        mode_set = PQsetSingleRowMode(conn->raw_conn);
     }
+#else
+    (void)chunk_size;
+    mode_set = PQsetSingleRowMode(conn->raw_conn);
+#endif
+
+    if (mode_set != 1) {
+        set_error(conn, "Failed to enable row-by-row result mode");
+        consume_results(conn);
+        return false;
+    }
+
+    conn->stream_active = true;
+    conn->stream_done   = false;
+    conn->op_timeout_ms = opts->timeout_ms;
 
-    PQclear(res);
     update_activity(conn);
+    return true;
+}
 
-    return success;
+bool pgconn_stream_begin(pgconn_t* conn, const char* query, int n_params, const char* const* param_values,
+                         int chunk_size, const pgconn_query_opts_t* opts) {
+    // Simplified version: text parameters and text results
+    return pgconn_stream_begin_full(conn, query, n_params, NULL, param_values, NULL, NULL, 0, chunk_size, opts);
 }
 
-bool pgconn_prepare_safe(pgconn_t* conn, const char* stmt_name, const char* query, int n_params,
-                         const Oid* param_types) {
-    if (!conn) return false;
+int pgconn_stream_next(pgconn_t* conn, PGresult** result) {
+    if (!conn || !conn->raw_conn || !conn->stream_active) {
+        set_error(conn, "No streaming query in progress");
+        return -1;
+    }
 
-    if (conn->thread_safe) {
-        pthread_mutex_lock(&conn->lock);
+    if (!result) {
+        set_error(conn, "Invalid output pointer");
+        return -1;
     }
 
-    bool result = pgconn_prepare(conn, stmt_name, query, n_params, param_types);
+    *result = NULL;
+    if (conn->stream_done) {
+        return 0;
+    }
 
-    if (conn->thread_safe) {
-        pthread_mutex_unlock(&conn->lock);
+    if (PQisBusy(conn->raw_conn) && !wait_for_result(conn, conn->op_timeout_ms)) {
+        return -1;
     }
 
-    return result;
-}
+    PGresult* res = PQgetResult(conn->raw_conn);
+    update_activity(conn);
 
-PGresult* pgconn_execute_prepared_full(pgconn_t* conn, const char* stmt_name, int n_params,
-                                       const char* const* param_values, const int* param_lengths,
-                                       const int* param_formats, int result_format, const pgconn_query_opts_t* opts) {
-    if (!conn || !conn->raw_conn || !stmt_name) {
-        set_error(conn, "Invalid connection or statement name");
-        return NULL;
+    if (!res) {
+        conn->stream_done = true;
+        return 0;
     }
 
-    if (!opts) {
-        opts = &DEFAULT_QUERY_OPTS;
-    }
+    ExecStatusType status = PQresultStatus(res);
+    switch (status) {
+        case PGRES_SINGLE_TUPLE:
+#ifdef LIBPQ_HAS_CHUNK_MODE
+        case PGRES_TUPLES_CHUNK:
+#endif
+            *result = res;
+            return 1;
+
+        case PGRES_TUPLES_OK:
+        case PGRES_COMMAND_OK:
+            // Zero-row terminator (or a statement that returns no rows)
+            PQclear(res);
+            consume_results(conn);
+            conn->stream_done = true;
+            return 0;
 
-    consume_results(conn);
-    set_error(conn, NULL);
+        default:
+            set_result_error(conn, res);
+            PQclear(res);
+            consume_results(conn);
+            conn->stream_done = true;
+            return -1;
+    }
+}
 
-    // Use PQexecPrepared for simplicity when no timeout
-    if (opts->timeout_ms < 0) {
-        PGresult* res = PQexecPrepared(
-            conn->raw_conn, stmt_name, n_params, param_values, param_lengths, param_formats, result_format);
-        if (!res) {
-            set_error(conn, "No result received from prepared statement");
-            return NULL;
-        }
+bool pgconn_stream_end(pgconn_t* conn) {
+    if (!conn || !conn->stream_active) {
+        set_error(conn, "No streaming query in progress");
+        return false;
+    }
 
-        ExecStatusType status = PQresultStatus(res);
-        if (status != PGRES_COMMAND_OK && status != PGRES_TUPLES_OK) {
-            set_error(conn, PQresultErrorMessage(res));
-            PQclear(res);
-            res = NULL;
-        }
+    conn->stream_active = false;
 
-        update_activity(conn);
-        return res;
+    if (conn->stream_done) {
+        return conn->last_error[0] == '\0';
     }
 
-    // With timeout, use async API
-    if (PQsendQueryPrepared(
-            conn->raw_conn, stmt_name, n_params, param_values, param_lengths, param_formats, result_format) != 1) {
-        set_error(conn, PQerrorMessage(conn->raw_conn));
-        return NULL;
+    // Stopped early: cancel the query and discard the rows still in flight
+    // (unless a timeout already closed the connection)
+    if (conn->raw_conn) {
+        cancel_and_drain(conn);
     }
 
-    if (!wait_for_result(conn, opts->timeout_ms)) {
-        return NULL;
+    if (conn->last_error[0] == '\0') {
+        set_error(conn, "Streaming query stopped before completion");
     }
+    return false;
+}
 
-    PGresult* res = PQgetResult(conn->raw_conn);
-    if (!res) {
-        set_error(conn, "No result received from prepared statement");
-        return NULL;
+// === Asynchronous Queries ===
+
+/** Checks that an asynchronous query can be sent and prepares the connection for it. */
+static bool begin_async(pgconn_t* conn) {
+    if (conn->async_active) {
+        set_error(conn, "An asynchronous query is already in progress");
+        return false;
     }
 
-    ExecStatusType status = PQresultStatus(res);
-    if (status != PGRES_COMMAND_OK && status != PGRES_TUPLES_OK) {
-        set_error(conn, PQresultErrorMessage(res));
-        PQclear(res);
-        res = NULL;
+    if (!check_session_idle(conn)) {
+        return false;
     }
 
     consume_results(conn);
-    update_activity(conn);
+    set_error(conn, NULL);
+    ensure_prepared(conn);
 
-    return res;
+    // Drop a result the caller never collected
+    PQclear(conn->async_result);
+    conn->async_result = NULL;
+
+    if (PQsetnonblocking(conn->raw_conn, 1) != 0) {
+        set_error(conn, PQerrorMessage(conn->raw_conn));
+        return false;
+    }
+    return true;
 }
 
-PGresult* pgconn_execute_prepared_full_safe(pgconn_t* conn, const char* stmt_name, int n_params,
-                                            const char* const* param_values, const int* param_lengths,
-                                            const int* param_formats, int result_format,
-                                            const pgconn_query_opts_t* opts) {
-    if (!conn) return NULL;
+/** Records a sent asynchronous query, or restores blocking mode if sending failed. */
+static bool finish_send(pgconn_t* conn, int sent, pgconn_result_fn fn, void* user_data) {
+    if (sent != 1 || PQflush(conn->raw_conn) < 0) {
+        set_error(conn, PQerrorMessage(conn->raw_conn));
+        consume_results(conn);
+        PQsetnonblocking(conn->raw_conn, 0);
+        return false;
+    }
 
-    if (conn->thread_safe) {
-        pthread_mutex_lock(&conn->lock);
+    conn->async_active    = true;
+    conn->async_fn        = fn;
+    conn->async_user_data = user_data;
+
+    update_activity(conn);
+    return true;
+}
+
+/** Ends the asynchronous query and delivers its result. */
+static pgconn_poll_status_t complete_async(pgconn_t* conn) {
+    PGresult* res      = conn->async_result;
+    conn->async_result = NULL;
+    conn->async_active = false;
+
+    PQsetnonblocking(conn->raw_conn, 0);
+    update_activity(conn);
+
+    if (!res && conn->last_error[0] == '\0') {
+        set_error(conn, "No result received from asynchronous query");
     }
 
-    PGresult* result = pgconn_execute_prepared_full(
-        conn, stmt_name, n_params, param_values, param_lengths, param_formats, result_format, opts);
+    pgconn_poll_status_t status = res ? PGCONN_POLL_DONE : PGCONN_POLL_FAILED;
 
-    if (conn->thread_safe) {
-        pthread_mutex_unlock(&conn->lock);
+    if (conn->async_fn) {
+        // The connection is idle again, so the callback may send the next query
+        pgconn_result_fn fn = conn->async_fn;
+        conn->async_fn      = NULL;
+        fn(conn, res, conn->async_user_data);
+    } else {
+        conn->async_result = res;
     }
 
-    return result;
+    return status;
 }
 
-PGresult* pgconn_execute_prepared(pgconn_t* conn, const char* stmt_name, int n_params, const char* const* param_values,
-                                  const pgconn_query_opts_t* opts) {
-    // Simplified version: assumes all params are null-terminated text strings
-    // and result is requested as text.
-    return pgconn_execute_prepared_full(conn, stmt_name, n_params, param_values, NULL, NULL, 0, opts);
-}
+bool pgconn_send_query_params_full(pgconn_t* conn, const char* query, int n_params, const Oid* param_types,
+                                   const char* const* param_values, const int* param_lengths,
+                                   const int* param_formats, int result_format, pgconn_result_fn fn,
+                                   void* user_data) {
+    if (!conn || !conn->raw_conn || !query) {
+        set_error(conn, "Invalid connection or query");
+        return false;
+    }
 
-PGresult* pgconn_execute_prepared_safe(pgconn_t* conn, const char* stmt_name, int n_params,
-                                       const char* const* param_values, const pgconn_query_opts_t* opts) {
-    if (!conn) return NULL;
+    if (n_params < 0) n_params = 0;
 
-    if (conn->thread_safe) {
-        pthread_mutex_lock(&conn->lock);
+    if (!begin_async(conn)) {
+        return false;
     }
 
-    PGresult* result = pgconn_execute_prepared(conn, stmt_name, n_params, param_values, opts);
+    int sent = PQsendQueryParams(
+        conn->raw_conn, query, n_params, param_types, param_values, param_lengths, param_formats, result_format);
+    return finish_send(conn, sent, fn, user_data);
+}
 
-    if (conn->thread_safe) {
-        pthread_mutex_unlock(&conn->lock);
+bool pgconn_send_query_params(pgconn_t* conn, const char* query, int n_params, const char* const* param_values,
+                              pgconn_result_fn fn, void* user_data) {
+    // Simplified version: text parameters and text results
+    return pgconn_send_query_params_full(conn, query, n_params, NULL, param_values, NULL, NULL, 0, fn, user_data);
+}
+
+bool pgconn_send_query(pgconn_t* conn, const char* query, pgconn_result_fn fn, void* user_data) {
+    if (!conn || !conn->raw_conn || !query) {
+        set_error(conn, "Invalid connection or query");
+        return false;
     }
 
-    return result;
+    if (!begin_async(conn)) {
+        return false;
+    }
+
+    // Simple query protocol, so the query may contain several statements
+    return finish_send(conn, PQsendQuery(conn->raw_conn, query), fn, user_data);
 }
 
-bool pgconn_deallocate(pgconn_t* conn, const char* stmt_name) {
+bool pgconn_send_prepared(pgconn_t* conn, const char* stmt_name, int n_params, const char* const* param_values,
+                          const int* param_lengths, const int* param_formats, int result_format,
+                          pgconn_result_fn fn, void* user_data) {
     if (!conn || !conn->raw_conn || !stmt_name) {
         set_error(conn, "Invalid connection or statement name");
         return false;
     }
 
-    set_error(conn, NULL);
+    if (!begin_async(conn)) {
+        return false;
+    }
 
-    // Build DEALLOCATE command
-    char query[512];
-    snprintf(query, sizeof(query), "DEALLOCATE %s", stmt_name);
+    int sent = PQsendQueryPrepared(
+        conn->raw_conn, stmt_name, n_params, param_values, param_lengths, param_formats, result_format);
+    return finish_send(conn, sent, fn, user_data);
+}
 
-    bool result = pgconn_execute(conn, query, NULL);
-    return result;
+int pgconn_socket(pgconn_t* conn) {
+    return conn && conn->raw_conn ? PQsocket(conn->raw_conn) : -1;
 }
 
-bool pgconn_deallocate_safe(pgconn_t* conn, const char* stmt_name) {
-    if (!conn) return false;
+pgconn_poll_status_t pgconn_poll(pgconn_t* conn) {
+    if (!conn || !conn->raw_conn || !conn->async_active) {
+        set_error(conn, "No asynchronous query in progress");
+        return PGCONN_POLL_FAILED;
+    }
 
-    if (conn->thread_safe) {
-        pthread_mutex_lock(&conn->lock);
+    // Reading first lets the server drain its side while we still have output queued
+    if (PQconsumeInput(conn->raw_conn) == 0) {
+        set_error(conn, PQerrorMessage(conn->raw_conn));
+        PQclear(conn->async_result);
+        conn->async_result = NULL;
+        return complete_async(conn);
     }
 
-    bool result = pgconn_deallocate(conn, stmt_name);
+    int flushed = PQflush(conn->raw_conn);
+    if (flushed < 0) {
+        set_error(conn, PQerrorMessage(conn->raw_conn));
+        PQclear(conn->async_result);
+        conn->async_result = NULL;
+        return complete_async(conn);
+    }
+    if (flushed == 1) {
+        return PGCONN_POLL_WRITING;
+    }
 
-    if (conn->thread_safe) {
-        pthread_mutex_unlock(&conn->lock);
+    // Collect every result of the query without blocking. As with PQexec(), the
+    // last result wins, except that the first error is kept.
+    while (!PQisBusy(conn->raw_conn)) {
+        PGresult* res = PQgetResult(conn->raw_conn);
+        if (!res) {
+            return complete_async(conn);
+        }
+
+        ExecStatusType status = PQresultStatus(res);
+        if (status == PGRES_COPY_IN || status == PGRES_COPY_OUT || status == PGRES_COPY_BOTH) {
+            // COPY needs its own protocol; PQgetResult() would return this forever
+            PQclear(res);
+            PQclear(conn->async_result);
+            conn->async_result = NULL;
+            set_error(conn, "COPY is not supported by asynchronous queries");
+            return complete_async(conn);
+        }
+
+        if (conn->last_error[0] != '\0') {
+            PQclear(res);
+            continue;
+        }
+
+        PQclear(conn->async_result);
+        conn->async_result = NULL;
+
+        if (status != PGRES_COMMAND_OK && status != PGRES_TUPLES_OK && status != PGRES_EMPTY_QUERY) {
+            set_result_error(conn, res);
+            PQclear(res);
+            continue;
+        }
+        conn->async_result = res;
     }
 
-    return result;
+    return PGCONN_POLL_READING;
+}
+
+PGresult* pgconn_async_result(pgconn_t* conn) {
+    if (!conn || conn->async_active) {
+        set_error(conn, "Asynchronous query has not completed");
+        return NULL;
+    }
+
+    PGresult* res      = conn->async_result;
+    conn->async_result = NULL;
+    return res;
+}
+
+bool pgconn_async_busy(pgconn_t* conn) {
+    return conn && conn->async_active;
 }
 
 // === Transaction Management ===
@@ -949,10 +3544,30 @@ const char* pgconn_error_message_safe(pgconn_t* conn) {
     return result;
 }
 
-void pgconn_clear_error(pgconn_t* conn) {
-    if (conn) {
-        conn->last_error[0] = '\0';
+const char* pgconn_error_sqlstate(pgconn_t* conn) {
+    return conn ? conn->last_sqlstate : "";
+}
+
+const char* pgconn_error_sqlstate_safe(pgconn_t* conn) {
+    if (!conn) {
+        return "";
+    }
+
+    if (conn->thread_safe) {
+        pthread_mutex_lock(&conn->lock);
+    }
+
+    const char* result = pgconn_error_sqlstate(conn);
+
+    if (conn->thread_safe) {
+        pthread_mutex_unlock(&conn->lock);
     }
+
+    return result;
+}
+
+void pgconn_clear_error(pgconn_t* conn) {
+    set_error(conn, NULL);
 }
 
 void pgconn_clear_error_safe(pgconn_t* conn) {
@@ -1017,6 +3632,26 @@ time_t pgconn_last_activity_safe(pgconn_t* conn) {
     return result;
 }
 
+time_t pgconn_created_at(pgconn_t* conn) {
+    return conn ? conn->created_at : 0;
+}
+
+time_t pgconn_created_at_safe(pgconn_t* conn) {
+    if (!conn) return 0;
+
+    if (conn->thread_safe) {
+        pthread_mutex_lock(&conn->lock);
+    }
+
+    time_t result = conn->created_at;
+
+    if (conn->thread_safe) {
+        pthread_mutex_unlock(&conn->lock);
+    }
+
+    return result;
+}
+
 uint32_t pgconn_connection_id(pgconn_t* conn) {
     return conn ? conn->connection_id : 0;
 }
@@ -1058,3 +3693,19 @@ bool pgconn_trylock(pgconn_t* conn) {
 
     return pthread_mutex_trylock(&conn->lock) == 0;
 }
+
+// === Pool Hooks ===
+
+bool pgconn_session_busy(pgconn_t* conn) {
+    return conn && (conn->async_active || conn->copy_in_active || conn->copy_out_active || conn->stream_active);
+}
+
+void pgconn_set_pool_slot(pgconn_t* conn, void* slot) {
+    if (conn) {
+        conn->pool_slot = slot;
+    }
+}
+
+void* pgconn_pool_slot(pgconn_t* conn) {
+    return conn ? conn->pool_slot : NULL;
+}
@@ -40,7 +40,7 @@ typedef struct {
     /** PostgreSQL connection string (required). */
     const char* conninfo;
 
-    /** Connection timeout in seconds (0 = use libpq default). */
+    /** Connection timeout in seconds for the whole handshake (0 = no limit beyond conninfo's). */
     int connect_timeout;
 
     /**
@@ -49,27 +49,99 @@ typedef struct {
      */
     bool thread_safe;
 
-    /** Enable automatic reconnection on connection loss. */
+    /**
+     * Enable automatic reconnection on connection loss. Query functions reopen a
+     * dead connection before sending (outside transactions) and after a failure
+     * that lost it; statements prepared with pgconn_prepare() are re-prepared.
+     * While the backoff of a failed attempt runs, they fail at once instead.
+     */
     bool auto_reconnect;
 
     /** Maximum reconnection attempts (0 = infinite). */
     int max_reconnect_attempts;
 
+    /**
+     * Backoff after a failed reconnection attempt, in milliseconds. The delay
+     * before attempt n is drawn uniformly from [0, min(max, base * 2^(n-1))]
+     * ("full jitter"), so many clients do not retry in lockstep.
+     * 0 = 100 ms base, 30000 ms maximum.
+     */
+    int reconnect_base_delay_ms;
+    int reconnect_max_delay_ms;
+
     /** Optional callback invoked after successful connection. */
     void (*connection_init)(PGconn* raw_conn);
 
     /** Optional callback invoked before connection close. */
     void (*connection_close)(PGconn* raw_conn);
+
+    /** Maximum statements kept prepared by pgconn_query_cached() (0 = 64). */
+    int statement_cache_size;
 } pgconn_config_t;
 
+/**
+ * Data format used by COPY operations.
+ */
+typedef enum {
+    PGCONN_COPY_TEXT = 0,  // Tab-separated text, \N for NULL
+    PGCONN_COPY_CSV,       // Comma-separated values, unquoted empty field for NULL
+    PGCONN_COPY_BINARY,    // PostgreSQL binary COPY format, values in binary send format
+} pgconn_copy_format_t;
+
+/**
+ * Progress reported by pgconn_poll() and pgconn_connect_poll().
+ */
+typedef enum {
+    PGCONN_POLL_READING = 0,  // Waiting for the server: wait until the socket is readable
+    PGCONN_POLL_WRITING,      // Output pending: wait until the socket is writable (queries: readable or writable)
+    PGCONN_POLL_DONE,         // Query or connection attempt finished successfully
+    PGCONN_POLL_FAILED,       // Query or connection attempt failed, see pgconn_error_message()
+} pgconn_poll_status_t;
+
+/**
+ * One row decoded from a binary COPY TO STDOUT stream.
+ * Pointers are valid until the next row is read or the COPY ends.
+ */
+typedef struct {
+    /** Number of fields in the row. */
+    int n_fields;
+
+    /** Field values in binary send format, not null-terminated. NULL for SQL NULL. */
+    const char* const* values;
+
+    /** Field lengths in bytes (-1 for SQL NULL). */
+    const int* lengths;
+} pgconn_copy_tuple_t;
+
+/**
+ * Receives one chunk (one row) of COPY TO STDOUT data.
+ * @return true to continue, false to stop the COPY early.
+ */
+typedef bool (*pgconn_copy_chunk_fn)(const char* data, size_t len, void* user_data);
+
+/**
+ * Receives one decoded row of a binary COPY TO STDOUT.
+ * @return true to continue, false to stop the COPY early.
+ */
+typedef bool (*pgconn_copy_tuple_fn)(const pgconn_copy_tuple_t* tuple, void* user_data);
+
 /**
  * Query execution options.
  */
 typedef struct {
-    /** Query timeout in milliseconds (-1 = infinite, 0 = no wait). */
+    /**
+     * Query timeout in milliseconds, measured against a monotonic deadline (-1 = infinite, 0 = no wait).
+     * On timeout the query is cancelled and its remaining results discarded; if it does not stop
+     * within a few seconds the connection is closed and pgconn_status() reports CONNECTION_BAD.
+     */
     int timeout_ms;
 
-    /** Automatically retry on connection failure (uses auto_reconnect). */
+    /**
+     * Run the query again after the connection was lost (CONNECTION_BAD or
+     * SQLSTATE class 08) and auto_reconnect restored it. Only set this for
+     * statements that are safe to repeat; queries inside a transaction and
+     * queries that timed out are never retried.
+     */
     bool retry_on_failure;
 } pgconn_query_opts_t;
 
@@ -100,6 +172,11 @@ PGconn* pgconn_get_raw(pgconn_t* conn);
 
 /**
  * Validates that the connection is alive and responsive.
+ *
+ * Sends SELECT 1 and waits at most 5 seconds for the answer. On timeout the
+ * query is cancelled (closing the connection if it does not stop) and the
+ * connection counts as broken.
+ *
  * @param conn Connection to validate.
  * @return true if connection is healthy, false otherwise.
  * @note Not thread-safe. Caller must ensure exclusive access.
@@ -113,11 +190,37 @@ bool pgconn_validate(pgconn_t* conn);
  */
 bool pgconn_validate_safe(pgconn_t* conn);
 
+/**
+ * Validates a connection without a round trip unless it has been idle a while.
+ *
+ * Checks PQstatus() and polls the socket with a zero timeout: an idle
+ * connection that became readable is read, which detects a closed socket or a
+ * server-side termination. Only if the connection has been idle for at least
+ * max_idle_s seconds (see pgconn_last_activity()) is a SELECT 1 sent as well,
+ * with the same time limit as pgconn_validate(). The probe does not count as
+ * activity.
+ *
+ * @param conn Connection to validate.
+ * @param max_idle_s Idle seconds before a query is sent (0 = always, -1 = never).
+ * @return true if connection is healthy, false otherwise.
+ * @note Not thread-safe. Caller must ensure exclusive access.
+ */
+bool pgconn_validate_fast(pgconn_t* conn, int max_idle_s);
+
+/**
+ * Validates a connection without a round trip unless idle (thread-safe version).
+ * @param conn Connection to validate.
+ * @param max_idle_s Idle seconds before a query is sent (0 = always, -1 = never).
+ * @return true if connection is healthy, false otherwise.
+ */
+bool pgconn_validate_fast_safe(pgconn_t* conn, int max_idle_s);
+
 /**
  * Attempts to reconnect a failed connection.
  * @param conn Connection to reconnect.
  * @return true on successful reconnection, false otherwise.
- * @note Not thread-safe. Caller must ensure exclusive access.
+ * @note Not thread-safe. Caller must ensure exclusive access. After a failed
+ *       attempt, the next call first sleeps for the jittered backoff delay.
  */
 bool pgconn_reconnect(pgconn_t* conn);
 
@@ -128,6 +231,55 @@ bool pgconn_reconnect(pgconn_t* conn);
  */
 bool pgconn_reconnect_safe(pgconn_t* conn);
 
+/**
+ * Starts opening a connection without blocking.
+ *
+ * Drive the attempt by waiting on pgconn_socket() as pgconn_connect_poll()
+ * directs and calling pgconn_connect_poll() until it returns PGCONN_POLL_DONE
+ * or PGCONN_POLL_FAILED. connect_timeout is enforced by pgconn_connect_poll(),
+ * so an event loop should also call it when its own timer for the attempt fires.
+ * Many connections can be opened in parallel this way from a single thread.
+ *
+ * @param config Connection configuration. Must not be NULL.
+ * @return New connection (still connecting), or NULL on invalid config or allocation failure.
+ * @note Caller must free with pgconn_destroy(), including after a failed attempt.
+ */
+pgconn_t* pgconn_connect_start(const pgconn_config_t* config);
+
+/**
+ * Closes a connection and starts reopening it without blocking.
+ * @param conn Connection to reconnect.
+ * @return true if the attempt was started (drive it with pgconn_connect_poll()), false otherwise,
+ *         including while the backoff delay of a failed attempt has not elapsed.
+ * @note Not thread-safe. Caller must ensure exclusive access.
+ */
+bool pgconn_reconnect_start(pgconn_t* conn);
+
+/**
+ * Gets the remaining backoff delay before the next reconnection attempt.
+ * @param conn Connection to inspect.
+ * @return Milliseconds to wait, 0 if a reconnection may be attempted now.
+ * @note Not thread-safe. Event loops can arm a timer with this before pgconn_reconnect_start().
+ */
+int pgconn_reconnect_delay_ms(pgconn_t* conn);
+
+/**
+ * Gets the remaining reconnection backoff delay (thread-safe version).
+ * @param conn Connection to inspect.
+ * @return Milliseconds to wait, 0 if a reconnection may be attempted now.
+ */
+int pgconn_reconnect_delay_ms_safe(pgconn_t* conn);
+
+/**
+ * Advances a connection attempt started by pgconn_connect_start() or pgconn_reconnect_start().
+ * @param conn Connection being opened.
+ * @return PGCONN_POLL_READING or PGCONN_POLL_WRITING to wait on pgconn_socket() (which may
+ *         change between calls), PGCONN_POLL_DONE once connected (connection_init has run),
+ *         or PGCONN_POLL_FAILED with the reason in pgconn_error_message().
+ * @note Not thread-safe. Caller must ensure exclusive access.
+ */
+pgconn_poll_status_t pgconn_connect_poll(pgconn_t* conn);
+
 // === Simple Query Execution ===
 
 /**
@@ -304,6 +456,406 @@ bool pgconn_deallocate(pgconn_t* conn, const char* stmt_name);
  */
 bool pgconn_deallocate_safe(pgconn_t* conn, const char* stmt_name);
 
+// === Statement Cache ===
+
+/**
+ * Executes a query through the connection's prepared-statement cache.
+ *
+ * The first call with a given SQL string prepares it under a generated name;
+ * later calls with the same text skip parsing and planning and execute the
+ * prepared statement directly. When the cache is full, the least recently used
+ * statement is deallocated. Reconnecting empties the cache. A statement that
+ * disappeared from the server (SQLSTATE 26000, e.g. after DISCARD ALL) is
+ * prepared again transparently.
+ *
+ * @param conn Connection to use.
+ * @param query SQL query with $1, $2, ... placeholders. Must not be NULL.
+ * @param n_params Number of parameters.
+ * @param param_values Array of parameter values (null-terminated strings).
+ * @param opts Query execution options (timeout_ms applies separately to the
+ *             eviction, the prepare and the execution). NULL uses defaults.
+ * @return PGresult on success (text format), NULL on failure.
+ * @note Not thread-safe. Caller must free result with PQclear().
+ */
+PGresult* pgconn_query_cached(pgconn_t* conn, const char* query, int n_params, const char* const* param_values,
+                              const pgconn_query_opts_t* opts);
+
+/**
+ * Executes a query through the statement cache (thread-safe version).
+ * @note See pgconn_query_cached() for parameter documentation.
+ */
+PGresult* pgconn_query_cached_safe(pgconn_t* conn, const char* query, int n_params, const char* const* param_values,
+                                   const pgconn_query_opts_t* opts);
+
+// === Pipeline Mode ===
+//
+// Pipeline mode queues many queries and reads their results later, so a batch
+// costs one network round trip instead of one per query. Requires libpq 14+.
+// These functions span several calls and have no _safe variants; on a shared
+// connection, hold pgconn_lock() from pgconn_pipeline_begin() to pgconn_pipeline_end().
+
+/**
+ * Switches the connection into pipeline mode.
+ *
+ * The connection stays in nonblocking mode until pgconn_pipeline_end(). Each
+ * send pushes what the socket accepts and reads results that have already
+ * arrived, so batches of any size cannot deadlock against the server.
+ *
+ * @param conn Connection to use. Must be idle.
+ * @return true on success, false on failure.
+ * @note Not thread-safe. Regular query functions fail until pgconn_pipeline_end().
+ */
+bool pgconn_pipeline_begin(pgconn_t* conn);
+
+/**
+ * Leaves pipeline mode.
+ * @param conn Connection to use.
+ * @return true on success, false if results are still pending.
+ * @note Not thread-safe. Read all results with pgconn_pipeline_next_result() first.
+ */
+bool pgconn_pipeline_end(pgconn_t* conn);
+
+/**
+ * Queues a query without parameters.
+ * @param conn Connection in pipeline mode.
+ * @param query Single SQL statement. Must not be NULL.
+ * @return true if the query was queued, false on failure.
+ * @note Not thread-safe.
+ */
+bool pgconn_pipeline_send_query(pgconn_t* conn, const char* query);
+
+/**
+ * Queues a parameterized query.
+ * @note See pgconn_query_params_full() for parameter documentation.
+ * @return true if the query was queued, false on failure.
+ * @note Not thread-safe.
+ */
+bool pgconn_pipeline_send_query_params(pgconn_t* conn, const char* query, int n_params, const Oid* param_types,
+                                       const char* const* param_values, const int* param_lengths,
+                                       const int* param_formats, int result_format);
+
+/**
+ * Queues the preparation of a statement.
+ * @note See pgconn_prepare() for parameter documentation.
+ * @return true if the request was queued, false on failure.
+ * @note Not thread-safe. Produces one result (PGRES_COMMAND_OK on success).
+ */
+bool pgconn_pipeline_send_prepare(pgconn_t* conn, const char* stmt_name, const char* query, int n_params,
+                                  const Oid* param_types);
+
+/**
+ * Queues the execution of a prepared statement.
+ * @note See pgconn_execute_prepared_full() for parameter documentation.
+ * @return true if the request was queued, false on failure.
+ * @note Not thread-safe.
+ */
+bool pgconn_pipeline_send_prepared(pgconn_t* conn, const char* stmt_name, int n_params,
+                                   const char* const* param_values, const int* param_lengths,
+                                   const int* param_formats, int result_format);
+
+/**
+ * Marks a synchronization point and starts flushing queued queries to the server.
+ * Whatever the socket does not accept yet is sent by pgconn_pipeline_next_result().
+ * @param conn Connection in pipeline mode.
+ * @return true on success, false on failure.
+ * @note Not thread-safe. If a query fails, the server skips the remaining queries
+ *       up to the next sync point.
+ */
+bool pgconn_pipeline_sync(pgconn_t* conn);
+
+/**
+ * Reads the result of the next queued query, in the order the queries were sent.
+ * @param conn Connection in pipeline mode.
+ * @param opts Query execution options (timeout_ms applies to each wait). NULL uses defaults.
+ * @return Next result, or NULL when every synced query has been read or on I/O failure.
+ * @note Not thread-safe. Caller must free result with PQclear(). Failed queries
+ *       (PGRES_FATAL_ERROR) and skipped ones (PGRES_PIPELINE_ABORTED) are returned
+ *       too, so results stay aligned with queries; their message is also stored
+ *       in the connection error buffer.
+ */
+PGresult* pgconn_pipeline_next_result(pgconn_t* conn, const pgconn_query_opts_t* opts);
+
+/**
+ * Gets the number of queued queries whose results have not been read yet.
+ * @param conn Connection to query.
+ * @return Number of pending results, or 0 if conn is NULL.
+ * @note Not thread-safe.
+ */
+int pgconn_pipeline_pending(pgconn_t* conn);
+
+// === COPY FROM STDIN ===
+//
+// Streams rows into a table with a single COPY command. Rows are encoded and
+// buffered internally and sent in large chunks. These functions span several
+// calls and have no _safe variants; on a shared connection, hold pgconn_lock()
+// from pgconn_copy_in_begin() until pgconn_copy_in_end() or pgconn_copy_in_abort().
+// Other queries on the connection fail until then. A pool connection released
+// during a COPY is closed.
+
+/**
+ * Starts a COPY ... FROM STDIN operation.
+ * @param conn Connection to use. Must be idle.
+ * @param target Table name with optional column list, e.g. "items (id, name)". Not escaped.
+ * @param format Row encoding used by pgconn_copy_in_put_row().
+ * @param opts Query execution options (timeout_ms applies to begin, end and each wait for the
+ *             server to read buffered rows). NULL uses defaults.
+ * @return true if the server is ready to receive rows, false on failure.
+ * @note Not thread-safe.
+ */
+bool pgconn_copy_in_begin(pgconn_t* conn, const char* target, pgconn_copy_format_t format,
+                          const pgconn_query_opts_t* opts);
+
+/**
+ * Encodes and buffers one row.
+ * @param conn Connection in COPY IN state.
+ * @param n_fields Number of fields in the row.
+ * @param values Field values; a NULL entry is SQL NULL.
+ * @param lengths Field lengths in bytes (NULL = null-terminated strings). Required for binary format.
+ * @return true on success, false on failure ("Invalid row" for negative lengths, or
+ *         more than 32767 fields in binary format), or when the server stopped
+ *         reading for longer than timeout_ms; the COPY is then over.
+ * @note Not thread-safe. Text and CSV values are escaped as needed; binary values
+ *       must already be in the type's binary send format.
+ */
+bool pgconn_copy_in_put_row(pgconn_t* conn, int n_fields, const char* const* values, const int* lengths);
+
+/**
+ * Flushes buffered rows and completes the COPY.
+ * @param conn Connection in COPY IN state.
+ * @param rows_copied Optional output for the number of rows loaded by the server.
+ * @return true if the server accepted all rows, false on failure.
+ * @note Not thread-safe.
+ */
+bool pgconn_copy_in_end(pgconn_t* conn, int64_t* rows_copied);
+
+/**
+ * Cancels the COPY; the server discards every row sent so far.
+ * @param conn Connection in COPY IN state.
+ * @param reason Error message reported by the server (NULL for a default message).
+ * @return true if the COPY was aborted and the connection is idle again.
+ * @note Not thread-safe.
+ */
+bool pgconn_copy_in_abort(pgconn_t* conn, const char* reason);
+
+// === COPY TO STDOUT ===
+//
+// Streams query or table output without materializing a PGresult, so memory use
+// stays constant regardless of result size. Use either the callback functions or
+// the begin/next/end iterator. The iterator spans several calls and has no _safe
+// variants; on a shared connection, hold pgconn_lock() until pgconn_copy_out_end().
+// Other queries on the connection fail until then. A pool connection released
+// during the COPY is closed.
+
+/**
+ * Starts a COPY ... TO STDOUT operation.
+ * @param conn Connection to use. Must be idle.
+ * @param source Table name with optional column list, or a parenthesized query,
+ *               e.g. "(SELECT id, name FROM items)". Not escaped.
+ * @param format Output format.
+ * @param opts Query execution options (timeout_ms applies to each wait for data). NULL uses defaults.
+ * @return true if the server started sending data, false on failure.
+ * @note Not thread-safe.
+ */
+bool pgconn_copy_out_begin(pgconn_t* conn, const char* source, pgconn_copy_format_t format,
+                           const pgconn_query_opts_t* opts);
+
+/**
+ * Reads the next chunk of COPY data. Each chunk holds one row.
+ * @param conn Connection in COPY OUT state.
+ * @param data Output pointer to the chunk, valid until the next call or pgconn_copy_out_end().
+ * @param len Output chunk length in bytes.
+ * @return 1 if a chunk was read, 0 when the COPY completed, -1 on failure.
+ * @note Not thread-safe. Binary chunks include the COPY header and trailer.
+ */
+int pgconn_copy_out_next(pgconn_t* conn, const char** data, size_t* len);
+
+/**
+ * Reads and decodes the next row of a binary COPY.
+ * @param conn Connection in COPY OUT state, started with PGCONN_COPY_BINARY.
+ * @param tuple Output row, valid until the next call or pgconn_copy_out_end().
+ * @return 1 if a row was read, 0 when the COPY completed, -1 on failure.
+ * @note Not thread-safe. Field values use each type's binary send format.
+ */
+int pgconn_copy_out_next_tuple(pgconn_t* conn, pgconn_copy_tuple_t* tuple);
+
+/**
+ * Finishes the COPY and returns the connection to idle.
+ * @param conn Connection in COPY OUT state.
+ * @return true if the COPY ran to completion, false if it failed or was stopped early.
+ * @note Not thread-safe. Stopping early cancels the query and discards the remaining data.
+ */
+bool pgconn_copy_out_end(pgconn_t* conn);
+
+/**
+ * Streams COPY TO STDOUT data to a callback.
+ * @param conn Connection to use. Must be idle.
+ * @param source Table or parenthesized query (see pgconn_copy_out_begin()).
+ * @param format Output format.
+ * @param fn Callback invoked once per chunk. Must not be NULL.
+ * @param user_data Passed to fn unchanged.
+ * @param opts Query execution options. NULL uses defaults.
+ * @return true if every chunk was delivered, false on failure or if fn stopped the COPY.
+ * @note Not thread-safe.
+ */
+bool pgconn_copy_out(pgconn_t* conn, const char* source, pgconn_copy_format_t format, pgconn_copy_chunk_fn fn,
+                     void* user_data, const pgconn_query_opts_t* opts);
+
+/**
+ * Streams decoded rows of a binary COPY TO STDOUT to a callback.
+ * @param conn Connection to use. Must be idle.
+ * @param source Table or parenthesized query (see pgconn_copy_out_begin()).
+ * @param fn Callback invoked once per row. Must not be NULL.
+ * @param user_data Passed to fn unchanged.
+ * @param opts Query execution options. NULL uses defaults.
+ * @return true if every row was delivered, false on failure or if fn stopped the COPY.
+ * @note Not thread-safe.
+ */
+bool pgconn_copy_out_tuples(pgconn_t* conn, const char* source, pgconn_copy_tuple_fn fn, void* user_data,
+                            const pgconn_query_opts_t* opts);
+
+// === Streaming Queries ===
+//
+// Streams rows as they arrive instead of buffering the whole result, which cuts
+// time-to-first-row and keeps memory bounded by chunk_size. Each result handed
+// out holds one row (single-row mode) or up to chunk_size rows (chunked mode,
+// libpq 17+; older libpq falls back to single-row mode). These functions span
+// several calls and have no _safe variants; on a shared connection, hold
+// pgconn_lock() until pgconn_stream_end(). Other queries on the connection fail
+// until then. A pool connection released during a stream is closed.
+
+/**
+ * Sends a query and switches its result to row-by-row delivery.
+ * @param conn Connection to use. Must be idle.
+ * @param query SQL query with $1, $2, ... placeholders.
+ * @param n_params Number of parameters.
+ * @param param_values Array of parameter values (null-terminated strings).
+ * @param chunk_size Maximum rows per result (<= 1 = single-row mode).
+ * @param opts Query execution options (timeout_ms applies to each wait for rows). NULL uses defaults.
+ * @return true if the query was sent, false on failure.
+ * @note Not thread-safe.
+ */
+bool pgconn_stream_begin(pgconn_t* conn, const char* query, int n_params, const char* const* param_values,
+                         int chunk_size, const pgconn_query_opts_t* opts);
+
+/**
+ * Sends a query for row-by-row delivery with full control over parameters and result format.
+ * @note See pgconn_query_params_full() and pgconn_stream_begin() for parameter documentation.
+ */
+bool pgconn_stream_begin_full(pgconn_t* conn, const char* query, int n_params, const Oid* param_types,
+                              const char* const* param_values, const int* param_lengths, const int* param_formats,
+                              int result_format, int chunk_size, const pgconn_query_opts_t* opts);
+
+/**
+ * Reads the next batch of rows.
+ * @param conn Connection with a streaming query in progress.
+ * @param result Output result holding one row or one chunk of rows.
+ * @return 1 if rows were read, 0 when the query completed, -1 on failure.
+ * @note Not thread-safe. Caller must free each result with PQclear().
+ */
+int pgconn_stream_next(pgconn_t* conn, PGresult** result);
+
+/**
+ * Finishes a streaming query and returns the connection to idle.
+ * @param conn Connection with a streaming query in progress.
+ * @return true if every row was read, false if the query failed or was stopped early.
+ * @note Not thread-safe. Stopping early cancels the query and discards the remaining rows.
+ */
+bool pgconn_stream_end(pgconn_t* conn);
+
+// === Asynchronous Queries ===
+//
+// Non-blocking query execution for event loops. A pgconn_send_* call returns as
+// soon as the query is handed to libpq; the caller watches pgconn_socket() with
+// epoll/poll/select and calls pgconn_poll() whenever the socket is ready. One
+// thread can drive many connections this way. Only one asynchronous query may
+// be in flight per connection, and blocking pgconn_* calls fail on it until
+// pgconn_poll() reports completion. A pool closes a connection released with a
+// query still in flight instead of reusing it. These functions span several calls
+// and have no _safe variants; on a shared connection, hold pgconn_lock().
+
+/**
+ * Completion callback for an asynchronous query.
+ * @param conn Connection the query ran on (idle again when called).
+ * @param result Query result, or NULL on failure (see pgconn_error_message()).
+ *               Ownership passes to the callback, which must PQclear() it.
+ * @param user_data Pointer passed to pgconn_send_*().
+ */
+typedef void (*pgconn_result_fn)(pgconn_t* conn, PGresult* result, void* user_data);
+
+/**
+ * Sends a query without waiting for it to complete.
+ * @param conn Connection to use. Must be idle.
+ * @param query SQL query string.
+ * @param fn Completion callback invoked from pgconn_poll(). NULL keeps the result
+ *           for pgconn_async_result() instead.
+ * @param user_data Passed to fn.
+ * @return true if the query was sent, false on failure.
+ * @note Not thread-safe.
+ */
+bool pgconn_send_query(pgconn_t* conn, const char* query, pgconn_result_fn fn, void* user_data);
+
+/**
+ * Sends a parameterized query without waiting for it to complete.
+ * @note See pgconn_query_params() and pgconn_send_query() for parameter documentation.
+ */
+bool pgconn_send_query_params(pgconn_t* conn, const char* query, int n_params, const char* const* param_values,
+                              pgconn_result_fn fn, void* user_data);
+
+/**
+ * Sends a parameterized query with full control over parameters and result format.
+ * @note See pgconn_query_params_full() and pgconn_send_query() for parameter documentation.
+ */
+bool pgconn_send_query_params_full(pgconn_t* conn, const char* query, int n_params, const Oid* param_types,
+                                   const char* const* param_values, const int* param_lengths,
+                                   const int* param_formats, int result_format, pgconn_result_fn fn,
+                                   void* user_data);
+
+/**
+ * Sends an execution of a prepared statement without waiting for it to complete.
+ * @note See pgconn_execute_prepared_full() and pgconn_send_query() for parameter documentation.
+ */
+bool pgconn_send_prepared(pgconn_t* conn, const char* stmt_name, int n_params, const char* const* param_values,
+                          const int* param_lengths, const int* param_formats, int result_format,
+                          pgconn_result_fn fn, void* user_data);
+
+/**
+ * Gets the socket to watch for the connection.
+ * @param conn Connection to inspect.
+ * @return File descriptor, or -1 if the connection is closed.
+ * @note The descriptor changes after pgconn_reconnect() and may change during a
+ *       pgconn_connect_poll() sequence; re-register it.
+ */
+int pgconn_socket(pgconn_t* conn);
+
+/**
+ * Advances the asynchronous query without blocking.
+ *
+ * Reads whatever input is available and flushes pending output. When the query
+ * completes, the callback runs (or the result is stored) before this returns
+ * PGCONN_POLL_DONE or PGCONN_POLL_FAILED.
+ *
+ * @param conn Connection to advance.
+ * @return What the caller should wait for next, or the final outcome.
+ * @note Not thread-safe. Calling it with no query in flight returns PGCONN_POLL_FAILED.
+ */
+pgconn_poll_status_t pgconn_poll(pgconn_t* conn);
+
+/**
+ * Takes the result of a finished asynchronous query sent without a callback.
+ * @param conn Connection the query ran on.
+ * @return PGresult on success, NULL if the query failed or no result is pending.
+ * @note Not thread-safe. Caller must free result with PQclear().
+ */
+PGresult* pgconn_async_result(pgconn_t* conn);
+
+/**
+ * Checks whether an asynchronous query is in flight.
+ * @param conn Connection to inspect.
+ * @return true until pgconn_poll() reports completion.
+ * @note Not thread-safe.
+ */
+bool pgconn_async_busy(pgconn_t* conn);
+
 // === Transaction Management ===
 
 /**
@@ -384,6 +936,21 @@ const char* pgconn_error_message(pgconn_t* conn);
  */
 const char* pgconn_error_message_safe(pgconn_t* conn);
 
+/**
+ * Gets the SQLSTATE code of the last server error (e.g. "23505").
+ * @param conn Connection to query.
+ * @return Five-character code, or "" if the last error did not come from the server.
+ * @note Not thread-safe. Returns pointer to internal buffer.
+ */
+const char* pgconn_error_sqlstate(pgconn_t* conn);
+
+/**
+ * Gets the SQLSTATE code of the last server error (thread-safe version).
+ * @param conn Connection to query.
+ * @return Five-character code, or "" if the last error did not come from the server.
+ */
+const char* pgconn_error_sqlstate_safe(pgconn_t* conn);
+
 /**
  * Clears the last error message.
  * @param conn Connection to clear error for.
@@ -429,6 +996,22 @@ time_t pgconn_last_activity(pgconn_t* conn);
  */
 time_t pgconn_last_activity_safe(pgconn_t* conn);
 
+/**
+ * Gets the time the current session was established. A reconnect starts a
+ * new session and resets it.
+ * @param conn Connection to query.
+ * @return Unix timestamp of the last successful connect, or 0 if conn is NULL or never connected.
+ * @note Not thread-safe.
+ */
+time_t pgconn_created_at(pgconn_t* conn);
+
+/**
+ * Gets the time the current session was established (thread-safe version).
+ * @param conn Connection to query.
+ * @return Unix timestamp of the last successful connect, or 0 if conn is NULL or never connected.
+ */
+time_t pgconn_created_at_safe(pgconn_t* conn);
+
 /**
  * Gets the unique connection ID for debugging.
  * @param conn Connection to query.
@@ -0,0 +1,681 @@
+/**
+ * @file pgconn_coro.hpp
+ * @brief Optional C++20 coroutine layer over the asynchronous pgconn API.
+ *
+ * Lets coroutines wait for queries and pool checkouts without blocking a
+ * thread, so thousands of logical requests can share a handful of threads:
+ *
+ *     pgconn_coro::task<void> handle(pgconn_coro::pool& db, pgconn_coro::reactor& r) {
+ *         pgconn_coro::connection conn = co_await db.acquire(r);
+ *         if (!conn) co_return;
+ *
+ *         pgconn_coro::result res = co_await conn.query("SELECT $1::int", "42");
+ *         if (!res) fprintf(stderr, "%s\n", conn.error_message());
+ *     }  // conn goes back to the pool here
+ *
+ *     pgconn_coro::epoll_reactor r;
+ *     pgconn_coro::spawn(r, handle(db, r));
+ *     r.run();  // Until r.stop()
+ *
+ * Design principles:
+ * - Header-only; the C library is unchanged and needs no C++ toolchain.
+ * - One reactor per thread (epoll here, io_uring in pgconn_uring.hpp). A
+ *   coroutine always resumes on the reactor it passed to acquire() (or that
+ *   its connection was bound to).
+ * - Queries go through pgconn_send_*() and pgconn_poll(), so a connection runs
+ *   one query at a time and follows the same error reporting as the C API.
+ * - Waiting for a pool connection never blocks: waiters are queued and woken
+ *   by pool::release(). Opening a new pool connection still blocks the
+ *   acquiring reactor briefly, but never the releasing one.
+ */
+
+#ifndef PGCONN_CORO_HPP
+#define PGCONN_CORO_HPP
+
+#if __cplusplus < 202002L
+#error "pgconn_coro.hpp requires C++20"
+#endif
+
+#include <poll.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <unistd.h>
+
+#include <array>
+#include <atomic>
+#include <cerrno>
+#include <coroutine>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <system_error>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "pgconn.h"
+#include "pgpool.h"
+
+namespace pgconn_coro {
+
+// === Results ===
+
+/** Frees a PGresult with PQclear(). */
+struct result_deleter {
+    void operator()(PGresult* res) const noexcept { PQclear(res); }
+};
+
+/** Owned query result; empty when the query failed (see connection::error_message()). */
+using result = std::unique_ptr<PGresult, result_deleter>;
+
+// === Reactor ===
+
+/** Operation waiting for a socket. on_ready runs on the reactor thread. */
+struct io_op {
+    void (*on_ready)(io_op* op) = nullptr;
+};
+
+/**
+ * Event loop that resumes coroutines. Run one per thread; post() and stop()
+ * may be called from any thread. Backends implement the socket waits:
+ * epoll_reactor here, uring_reactor in pgconn_uring.hpp.
+ */
+class reactor {
+public:
+    reactor() : wakefd_(eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK)) {
+        if (wakefd_ < 0) {
+            throw std::system_error(errno, std::system_category(), "pgconn: Failed to create reactor");
+        }
+    }
+
+    virtual ~reactor() { close(wakefd_); }
+
+    reactor(const reactor&)            = delete;
+    reactor& operator=(const reactor&) = delete;
+
+    /** Resumes posted coroutines and socket waiters until stop() is called. */
+    virtual void run() = 0;
+
+    /**
+     * Calls op->on_ready once fd is ready for events (EPOLLIN or EPOLLOUT).
+     * Each call arms a single notification.
+     * @return false if the descriptor cannot be watched.
+     */
+    virtual bool wait(int fd, uint32_t events, io_op* op) noexcept = 0;
+
+    /** Tells the backend that no more waits on fd are expected for now (the query finished). */
+    virtual void idle(int fd) noexcept { (void)fd; }
+
+    /** Makes run() return after the current round. Thread-safe. */
+    void stop() noexcept {
+        stopped_.store(true, std::memory_order_release);
+        wake();
+    }
+
+    /** Number of event-loop system calls made so far (waits and registrations, not socket I/O). */
+    uint64_t syscall_count() const noexcept { return syscalls_; }
+
+    /** Resumes a coroutine on the reactor thread. Thread-safe. */
+    void post(std::coroutine_handle<> handle) {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            posted_.push_back(handle);
+        }
+        wake();
+    }
+
+protected:
+    uint64_t syscalls_ = 0;  // Incremented by backends, read by syscall_count()
+
+    bool stopped() const noexcept { return stopped_.load(std::memory_order_acquire); }
+
+    /** Descriptor that becomes readable when post() or stop() was called. */
+    int wake_fd() const noexcept { return wakefd_; }
+
+    /** Resumes everything posted so far; call when wake_fd() is readable. */
+    void drain_posted() {
+        uint64_t count;
+        ssize_t rc = read(wakefd_, &count, sizeof(count));
+        (void)rc;
+
+        std::vector<std::coroutine_handle<>> ready;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            ready.swap(posted_);
+        }
+        for (std::coroutine_handle<> handle : ready) {
+            handle.resume();
+        }
+    }
+
+private:
+    void wake() noexcept {
+        uint64_t one = 1;
+        ssize_t rc   = write(wakefd_, &one, sizeof(one));
+        (void)rc;  // EAGAIN means a wake-up is already pending
+    }
+
+    int wakefd_;
+    std::atomic<bool> stopped_{false};
+    std::mutex mutex_;                             // Guards posted_
+    std::vector<std::coroutine_handle<>> posted_;  // Coroutines to resume on the next round
+};
+
+/** Reactor backed by epoll, with one-shot registrations re-armed by each wait(). */
+class epoll_reactor final : public reactor {
+public:
+    epoll_reactor() : epfd_(epoll_create1(EPOLL_CLOEXEC)) {
+        epoll_event ev{};
+        ev.events   = EPOLLIN;
+        ev.data.ptr = nullptr;  // Marks the wake-up descriptor
+
+        if (epfd_ < 0 || epoll_ctl(epfd_, EPOLL_CTL_ADD, wake_fd(), &ev) != 0) {
+            int err = errno;
+            if (epfd_ >= 0) close(epfd_);
+            throw std::system_error(err, std::system_category(), "pgconn: Failed to create epoll reactor");
+        }
+    }
+
+    ~epoll_reactor() override { close(epfd_); }
+
+    void run() override {
+        epoll_event events[64];
+
+        while (!stopped()) {
+            syscalls_++;
+            int n = epoll_wait(epfd_, events, 64, -1);
+            if (n < 0) {
+                if (errno == EINTR) continue;
+                throw std::system_error(errno, std::system_category(), "pgconn: epoll_wait failed");
+            }
+
+            for (int i = 0; i < n; i++) {
+                if (!events[i].data.ptr) {
+                    drain_posted();
+                } else {
+                    auto* op = static_cast<io_op*>(events[i].data.ptr);
+                    op->on_ready(op);
+                }
+            }
+        }
+    }
+
+    bool wait(int fd, uint32_t events, io_op* op) noexcept override {
+        epoll_event ev{};
+        ev.events   = events | EPOLLONESHOT;
+        ev.data.ptr = op;
+
+        // Descriptors stay registered (disarmed) between waits; a closed one drops out by itself
+        syscalls_++;
+        if (epoll_ctl(epfd_, EPOLL_CTL_MOD, fd, &ev) == 0) {
+            return true;
+        }
+        syscalls_++;
+        return errno == ENOENT && epoll_ctl(epfd_, EPOLL_CTL_ADD, fd, &ev) == 0;
+    }
+
+private:
+    int epfd_;
+};
+
+// === Tasks ===
+
+template <typename T = void>
+class task;
+
+namespace detail {
+
+/** Resumes whoever awaited the finished task. */
+struct final_awaiter {
+    bool await_ready() const noexcept { return false; }
+
+    template <typename Promise>
+    std::coroutine_handle<> await_suspend(std::coroutine_handle<Promise> handle) noexcept {
+        std::coroutine_handle<> next = handle.promise().continuation;
+        return next ? next : std::noop_coroutine();
+    }
+
+    void await_resume() const noexcept {}
+};
+
+struct promise_base {
+    std::coroutine_handle<> continuation;
+    std::exception_ptr error;
+
+    std::suspend_always initial_suspend() const noexcept { return {}; }
+    final_awaiter final_suspend() const noexcept { return {}; }
+    void unhandled_exception() noexcept { error = std::current_exception(); }
+};
+
+template <typename T>
+struct task_promise : promise_base {
+    std::optional<T> value;
+
+    task<T> get_return_object() noexcept;
+
+    template <typename U>
+    void return_value(U&& v) {
+        value.emplace(std::forward<U>(v));
+    }
+
+    T take() {
+        if (error) std::rethrow_exception(error);
+        return std::move(*value);
+    }
+};
+
+template <>
+struct task_promise<void> : promise_base {
+    task<void> get_return_object() noexcept;
+
+    void return_void() noexcept {}
+
+    void take() {
+        if (error) std::rethrow_exception(error);
+    }
+};
+
+}  // namespace detail
+
+/**
+ * Lazily started coroutine returning T. It runs when first awaited and
+ * resumes its awaiter when done; exceptions propagate to the awaiter.
+ */
+template <typename T>
+class task {
+public:
+    using promise_type = detail::task_promise<T>;
+    using handle_type  = std::coroutine_handle<promise_type>;
+
+    explicit task(handle_type handle) noexcept : handle_(handle) {}
+    task(task&& other) noexcept : handle_(std::exchange(other.handle_, {})) {}
+
+    task& operator=(task&& other) noexcept {
+        if (this != &other) {
+            if (handle_) handle_.destroy();
+            handle_ = std::exchange(other.handle_, {});
+        }
+        return *this;
+    }
+
+    task(const task&)            = delete;
+    task& operator=(const task&) = delete;
+
+    ~task() {
+        if (handle_) handle_.destroy();
+    }
+
+    bool await_ready() const noexcept { return !handle_ || handle_.done(); }
+
+    std::coroutine_handle<> await_suspend(std::coroutine_handle<> awaiting) noexcept {
+        handle_.promise().continuation = awaiting;
+        return handle_;
+    }
+
+    T await_resume() { return handle_.promise().take(); }
+
+private:
+    handle_type handle_;
+};
+
+namespace detail {
+
+template <typename T>
+task<T> task_promise<T>::get_return_object() noexcept {
+    return task<T>(std::coroutine_handle<task_promise<T>>::from_promise(*this));
+}
+
+inline task<void> task_promise<void>::get_return_object() noexcept {
+    return task<void>(std::coroutine_handle<task_promise<void>>::from_promise(*this));
+}
+
+/** Fire-and-forget coroutine that frees itself when it finishes. */
+struct detached {
+    struct promise_type {
+        detached get_return_object() noexcept {
+            return {std::coroutine_handle<promise_type>::from_promise(*this)};
+        }
+        std::suspend_always initial_suspend() const noexcept { return {}; }
+        std::suspend_never final_suspend() const noexcept { return {}; }
+        void return_void() const noexcept {}
+        void unhandled_exception() const noexcept { std::terminate(); }
+    };
+
+    std::coroutine_handle<promise_type> handle;
+};
+
+inline detached run_detached(task<void> t) {
+    co_await std::move(t);
+}
+
+}  // namespace detail
+
+/**
+ * Starts a task on the reactor's thread without awaiting it. Thread-safe.
+ * @note An exception escaping the task calls std::terminate().
+ */
+inline void spawn(reactor& r, task<void> t) {
+    r.post(detail::run_detached(std::move(t)).handle);
+}
+
+// === Queries ===
+
+/** How a query_awaiter sends its query. */
+enum class query_kind { simple, params, prepared };
+
+/**
+ * Awaitable for one query. Sends it with pgconn_send_*(), then advances it
+ * with pgconn_poll() whenever the reactor reports the socket ready.
+ * N parameters are stored in the awaiter; with N = 0, params points to the
+ * caller's array (if any).
+ */
+template <std::size_t N>
+class query_awaiter : private io_op {
+public:
+    query_awaiter(pgconn_t* conn, reactor* r, query_kind k, const char* text, std::array<const char*, N> values,
+                  const char* const* params = nullptr, int n_params = static_cast<int>(N)) noexcept
+        : conn_(conn), reactor_(r), kind_(k), text_(text), values_(values), params_(params), n_params_(n_params) {
+        on_ready = &query_awaiter::ready;
+    }
+
+    query_awaiter(const query_awaiter&)            = delete;
+    query_awaiter& operator=(const query_awaiter&) = delete;
+
+    bool await_ready() const noexcept { return false; }
+
+    bool await_suspend(std::coroutine_handle<> waiter) noexcept {
+        waiter_ = waiter;
+        return send() && !advance();  // Resume at once on a send failure or instant completion
+    }
+
+    result await_resume() noexcept { return std::move(result_); }
+
+private:
+    bool send() noexcept {
+        if (!conn_ || !reactor_) {
+            return false;
+        }
+
+        // The stored values are only referenced now that the awaiter has its final address
+        const char* const* params = N > 0 ? values_.data() : params_;
+
+        switch (kind_) {
+            case query_kind::simple:
+                return pgconn_send_query(conn_, text_, nullptr, nullptr);
+            case query_kind::params:
+                return pgconn_send_query_params(conn_, text_, n_params_, params, nullptr, nullptr);
+            case query_kind::prepared:
+                return pgconn_send_prepared(conn_, text_, n_params_, params, nullptr, nullptr, 0, nullptr, nullptr);
+        }
+        return false;
+    }
+
+    /** Advances the query; returns true once it has finished, otherwise arms a socket wait. */
+    bool advance() noexcept {
+        pgconn_poll_status_t status = pgconn_poll(conn_);
+
+        while (status == PGCONN_POLL_READING || status == PGCONN_POLL_WRITING) {
+            uint32_t events = status == PGCONN_POLL_READING ? EPOLLIN : EPOLLOUT;
+            if (reactor_->wait(pgconn_socket(conn_), events, this)) {
+                return false;
+            }
+
+            // The socket cannot be watched (out of epoll resources): finish the query in place
+            pollfd pfd{pgconn_socket(conn_), static_cast<short>(events == EPOLLIN ? POLLIN : POLLOUT), 0};
+            ::poll(&pfd, 1, -1);
+            status = pgconn_poll(conn_);
+        }
+
+        if (status == PGCONN_POLL_DONE) {
+            result_.reset(pgconn_async_result(conn_));
+        }
+        reactor_->idle(pgconn_socket(conn_));
+        return true;
+    }
+
+    static void ready(io_op* op) {
+        auto* self = static_cast<query_awaiter*>(op);
+        if (self->advance()) {
+            self->waiter_.resume();
+        }
+    }
+
+    pgconn_t* conn_;
+    reactor* reactor_;
+    query_kind kind_;
+    const char* text_;
+    std::array<const char*, N> values_;
+    const char* const* params_;
+    int n_params_;
+    std::coroutine_handle<> waiter_;
+    result result_;
+};
+
+class pool;
+
+/**
+ * A pgconn_t bound to the reactor that resumes its queries. A connection
+ * from pool::acquire() returns to the pool when destroyed.
+ *
+ * Query strings and parameter strings must stay valid until the co_await
+ * completes; temporaries in the co_await expression do.
+ */
+class connection {
+public:
+    connection() noexcept = default;
+
+    /** Wraps a connection owned by the caller. */
+    connection(pgconn_t* conn, reactor& r) noexcept : conn_(conn), reactor_(&r) {}
+
+    connection(connection&& other) noexcept
+        : conn_(std::exchange(other.conn_, nullptr)), reactor_(other.reactor_),
+          pool_(std::exchange(other.pool_, nullptr)) {}
+
+    connection& operator=(connection&& other) noexcept {
+        if (this != &other) {
+            reset();
+            conn_    = std::exchange(other.conn_, nullptr);
+            reactor_ = other.reactor_;
+            pool_    = std::exchange(other.pool_, nullptr);
+        }
+        return *this;
+    }
+
+    connection(const connection&)            = delete;
+    connection& operator=(const connection&) = delete;
+
+    ~connection() { reset(); }
+
+    explicit operator bool() const noexcept { return conn_ != nullptr; }
+
+    /** Underlying connection, for synchronous pgconn_* calls between awaits. */
+    pgconn_t* get() const noexcept { return conn_; }
+
+    /** Error message of the last failed query. */
+    const char* error_message() const noexcept { return pgconn_error_message(conn_); }
+
+    /** Runs a query (several statements allowed, no parameters). */
+    query_awaiter<0> query(const char* sql) noexcept {
+        return query_awaiter<0>(conn_, reactor_, query_kind::simple, sql, {});
+    }
+
+    /** Runs a parameterized query with text parameters: query("... $1 ...", "42"). nullptr = SQL NULL. */
+    template <typename... Params>
+        requires(sizeof...(Params) > 0 && (std::is_convertible_v<Params, const char*> && ...))
+    query_awaiter<sizeof...(Params)> query(const char* sql, Params... params) noexcept {
+        return query_awaiter<sizeof...(Params)>(conn_, reactor_, query_kind::params, sql, {params...});
+    }
+
+    /** Runs a parameterized query with a caller-owned array of n_params text values. */
+    query_awaiter<0> query_params(const char* sql, int n_params, const char* const* values) noexcept {
+        return query_awaiter<0>(conn_, reactor_, query_kind::params, sql, {}, values, n_params);
+    }
+
+    /** Executes a prepared statement with text parameters. nullptr = SQL NULL. */
+    template <typename... Params>
+        requires(std::is_convertible_v<Params, const char*> && ...)
+    query_awaiter<sizeof...(Params)> execute_prepared(const char* stmt_name, Params... params) noexcept {
+        return query_awaiter<sizeof...(Params)>(conn_, reactor_, query_kind::prepared, stmt_name, {params...});
+    }
+
+    /**
+     * Returns a pooled connection to its pool now (otherwise done by the destructor).
+     * A connection with a query still in flight is closed by the pool instead.
+     */
+    void reset() noexcept;
+
+private:
+    friend class pool;
+
+    connection(pgconn_t* conn, reactor* r, pool* owner) noexcept : conn_(conn), reactor_(r), pool_(owner) {}
+
+    pgconn_t* conn_   = nullptr;
+    reactor* reactor_ = nullptr;
+    pool* pool_       = nullptr;
+};
+
+// === Pool ===
+
+/**
+ * Coroutine front end for a pgconn_pool_t. Waiters for an exhausted pool are
+ * queued; a release wakes the oldest one, which retries the checkout on its
+ * own reactor. Checkouts (and any connection the pool opens to grow) never
+ * run under the wrapper's lock or on the releasing thread.
+ *
+ * Check connections in and out only through this wrapper while it is in use,
+ * or queued coroutines may not be woken. It does not own the pgconn_pool_t.
+ */
+class pool {
+public:
+    explicit pool(pgconn_pool_t* p) noexcept : pool_(p) {}
+
+    pool(const pool&)            = delete;
+    pool& operator=(const pool&) = delete;
+
+    /**
+     * Checks out a connection, suspending while the pool is exhausted. The
+     * connection is empty if the pool could not open one and none is checked
+     * out (see pgconn_pool_error_message()).
+     */
+    task<connection> acquire(reactor& r) { return checkout(r, false); }
+
+    /** Checks out a read-only connection (see pgconn_pool_acquire_ro()), suspending while none is free. */
+    task<connection> acquire_ro(reactor& r) { return checkout(r, true); }
+
+    /** Returns a connection and wakes the oldest waiter to retry its checkout. */
+    void release(pgconn_t* conn) {
+        pgconn_pool_release(pool_, conn);
+
+        release_awaiter* waiter = nullptr;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            releases_.fetch_add(1, std::memory_order_release);
+            if (!waiters_.empty()) {
+                waiter = waiters_.front();
+                waiters_.pop_front();
+            }
+        }
+
+        if (waiter) {
+            waiter->reactor_->post(waiter->waiter_);
+        }
+    }
+
+private:
+    /** Suspends until the next release; resumes at once if one already happened since `seen`. */
+    class release_awaiter {
+    public:
+        release_awaiter(pool* owner, reactor* r, uint64_t seen) noexcept : owner_(owner), reactor_(r), seen_(seen) {}
+
+        bool await_ready() const noexcept { return false; }
+
+        bool await_suspend(std::coroutine_handle<> waiter) {
+            waiter_ = waiter;
+
+            std::vector<release_awaiter*> others;
+            {
+                std::lock_guard<std::mutex> lock(owner_->mutex_);
+
+                // A release since the failed checkout would otherwise be missed
+                if (owner_->releases_.load(std::memory_order_acquire) != seen_) {
+                    return false;
+                }
+
+                if (owner_->has_checkouts()) {
+                    owner_->waiters_.push_back(this);
+                    return true;
+                }
+
+                // Nothing will ever be released: fail now, and let every queued waiter find out too
+                gave_up_ = true;
+                others.assign(owner_->waiters_.begin(), owner_->waiters_.end());
+                owner_->waiters_.clear();
+            }
+
+            for (release_awaiter* other : others) {
+                other->reactor_->post(other->waiter_);
+            }
+            return false;
+        }
+
+        /** False when no connection is checked out, so waiting longer is pointless. */
+        bool await_resume() const noexcept { return !gave_up_; }
+
+    private:
+        friend class pool;
+
+        pool* owner_;
+        reactor* reactor_;
+        uint64_t seen_;
+        bool gave_up_ = false;
+        std::coroutine_handle<> waiter_;
+    };
+
+    task<connection> checkout(reactor& r, bool read_only) {
+        while (true) {
+            uint64_t seen  = releases_.load(std::memory_order_acquire);
+            pgconn_t* conn = read_only ? pgconn_pool_acquire_ro(pool_, 0) : pgconn_pool_acquire(pool_, 0);
+            if (conn) {
+                co_return connection(conn, &r, this);
+            }
+
+            if (!co_await release_awaiter(this, &r, seen)) {
+                co_return connection();
+            }
+        }
+    }
+
+    /** Whether some connection is checked out and will come back. */
+    bool has_checkouts() const noexcept {
+        pgconn_pool_stats_t stats;
+        pgconn_pool_stats(pool_, &stats);
+        return stats.in_use > 0;
+    }
+
+    pgconn_pool_t* pool_;
+    std::mutex mutex_;                       // Guards waiters_ and writes to releases_
+    std::atomic<uint64_t> releases_{0};      // Releases so far, to detect one racing a failed checkout
+    std::deque<release_awaiter*> waiters_;   // Suspended checkouts, oldest first
+};
+
+inline void connection::reset() noexcept {
+    // A frame destroyed while a query_awaiter is suspended leaves the query in
+    // flight: unhook the socket from the reactor, which would otherwise resume
+    // the destroyed awaiter, and let the pool close the busy connection
+    if (conn_ && reactor_ && pgconn_async_busy(conn_)) {
+        reactor_->idle(pgconn_socket(conn_));
+    }
+    if (pool_ && conn_) {
+        pool_->release(conn_);
+    }
+    conn_ = nullptr;
+    pool_ = nullptr;
+}
+
+}  // namespace pgconn_coro
+
+#endif  // PGCONN_CORO_HPP
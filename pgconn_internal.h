@@ -0,0 +1,48 @@
+/**
+ * @file pgconn_internal.h
+ * @brief Library-private hooks shared between pgconn.c and pgpool.c.
+ *
+ * This header is not installed. Nothing declared here is part of the public API.
+ */
+
+#ifndef PGCONN_INTERNAL_H
+#define PGCONN_INTERNAL_H
+
+#include "pgconn.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Defaults for pgconn_config_t.reconnect_base_delay_ms / reconnect_max_delay_ms
+#define PGCONN_RECONNECT_BASE_DELAY_MS 100
+#define PGCONN_RECONNECT_MAX_DELAY_MS 30000
+
+/**
+ * Attaches pool bookkeeping to a connection.
+ * @param conn Connection owned by a pool.
+ * @param slot Opaque pool slot pointer (NULL to detach).
+ */
+void pgconn_set_pool_slot(pgconn_t* conn, void* slot);
+
+/**
+ * Gets the pool bookkeeping attached to a connection.
+ * @param conn Connection to query.
+ * @return Slot pointer set by pgconn_set_pool_slot(), or NULL.
+ */
+void* pgconn_pool_slot(pgconn_t* conn);
+
+/**
+ * Checks whether an asynchronous query, a COPY (in either direction) or a
+ * streaming query still owns the connection, so that it cannot run ordinary
+ * queries until the caller ends it.
+ * @param conn Connection to query.
+ * @return true while an asynchronous query, COPY or stream is in progress.
+ */
+bool pgconn_session_busy(pgconn_t* conn);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // PGCONN_INTERNAL_H
@@ -0,0 +1,296 @@
+/**
+ * @file pgconn_uring.hpp
+ * @brief Optional io_uring reactor for the C++20 coroutine layer.
+ *
+ * A drop-in replacement for pgconn_coro::epoll_reactor on connections with
+ * many queries in flight. Every wait arms a one-shot poll, and all polls and
+ * cancellations of one loop round go to the kernel in the same
+ * io_uring_enter() call that waits for completions, so re-arming costs no
+ * extra syscall. A one-shot poll checks readiness when it is armed, so bytes
+ * that pgconn_poll() left unread in the socket wake the waiter again; a
+ * multishot poll only fires on new data and would strand them. Readiness is
+ * fed to libpq through pgconn_poll() exactly as with epoll.
+ *
+ *     pgconn_coro::uring_reactor r;
+ *     pgconn_coro::spawn(r, handle(db, r));
+ *     r.run();
+ *
+ * Requires Linux 5.5+. Uses the raw system calls, so liburing is not needed.
+ */
+
+#ifndef PGCONN_URING_HPP
+#define PGCONN_URING_HPP
+
+#include <linux/io_uring.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+
+#include <algorithm>
+#include <cstring>
+
+#include "pgconn_coro.hpp"
+
+namespace pgconn_coro {
+
+/** Reactor backed by io_uring with batched one-shot polls. */
+class uring_reactor final : public reactor {
+public:
+    /**
+     * Creates the ring.
+     * @param entries Submission queue size; it bounds the polls submitted per round, not the connections.
+     * @throws std::system_error if io_uring is unavailable.
+     */
+    explicit uring_reactor(unsigned entries = 256) {
+        io_uring_params params{};
+        // Not SINGLE_ISSUER: reactors are usually created on one thread and run on another
+        params.flags = IORING_SETUP_COOP_TASKRUN;
+
+        ring_fd_ = setup(entries, &params);
+        if (ring_fd_ < 0 && errno == EINVAL) {
+            params = io_uring_params{};  // Kernel before 5.19: no setup hints
+            ring_fd_ = setup(entries, &params);
+        }
+        if (ring_fd_ < 0) {
+            throw std::system_error(errno, std::system_category(), "pgconn: io_uring_setup failed");
+        }
+
+        if (!(params.features & IORING_FEAT_SINGLE_MMAP) || !(params.features & IORING_FEAT_NODROP)) {
+            close(ring_fd_);
+            throw std::system_error(ENOSYS, std::system_category(), "pgconn: io_uring needs Linux 5.5 or newer");
+        }
+
+        ring_size_ = std::max(params.sq_off.array + params.sq_entries * sizeof(unsigned),
+                              params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe));
+        sqes_size_ = params.sq_entries * sizeof(io_uring_sqe);
+
+        ring_ = mmap(nullptr, ring_size_, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ring_fd_,
+                     IORING_OFF_SQ_RING);
+        void* sqes = mmap(nullptr, sqes_size_, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ring_fd_,
+                          IORING_OFF_SQES);
+        if (ring_ == MAP_FAILED || sqes == MAP_FAILED) {
+            int err = errno;
+            if (ring_ != MAP_FAILED) munmap(ring_, ring_size_);
+            if (sqes != MAP_FAILED) munmap(sqes, sqes_size_);
+            close(ring_fd_);
+            throw std::system_error(err, std::system_category(), "pgconn: Failed to map io_uring");
+        }
+
+        auto* base = static_cast<char*>(ring_);
+        sq_head_   = reinterpret_cast<unsigned*>(base + params.sq_off.head);
+        sq_tail_   = reinterpret_cast<unsigned*>(base + params.sq_off.tail);
+        sq_mask_   = *reinterpret_cast<unsigned*>(base + params.sq_off.ring_mask);
+        sq_array_  = reinterpret_cast<unsigned*>(base + params.sq_off.array);
+        sq_size_   = params.sq_entries;
+        cq_head_   = reinterpret_cast<unsigned*>(base + params.cq_off.head);
+        cq_tail_   = reinterpret_cast<unsigned*>(base + params.cq_off.tail);
+        cq_mask_   = *reinterpret_cast<unsigned*>(base + params.cq_off.ring_mask);
+        cqes_      = reinterpret_cast<io_uring_cqe*>(base + params.cq_off.cqes);
+        sqes_      = static_cast<io_uring_sqe*>(sqes);
+        sq_local_  = *sq_tail_;
+
+        poll_add(wake_fd(), POLLIN, WAKE_TAG);
+    }
+
+    ~uring_reactor() override {
+        munmap(sqes_, sqes_size_);
+        munmap(ring_, ring_size_);
+        close(ring_fd_);
+    }
+
+    void run() override {
+        while (!stopped()) {
+            // Submit this round's polls and wait for at least one completion in the same call
+            if (enter(1, IORING_ENTER_GETEVENTS) < 0) {
+                if (errno == EINTR || errno == EAGAIN || errno == EBUSY) continue;
+                throw std::system_error(errno, std::system_category(), "pgconn: io_uring_enter failed");
+            }
+
+            reap();
+        }
+    }
+
+    bool wait(int fd, uint32_t events, io_op* op) noexcept override {
+        if (fd < 0) {
+            return false;
+        }
+        if (static_cast<size_t>(fd) >= fds_.size()) {
+            fds_.resize(static_cast<size_t>(fd) + 1);
+        }
+
+        fd_state& st = fds_[fd];
+        st.op        = op;
+
+        // A pending poll for the same direction has not fired yet, so it still covers this wait
+        uint32_t want = (events & EPOLLIN) ? EPOLLIN : EPOLLOUT;
+        if (st.armed && st.events == want) {
+            return true;
+        }
+        if (st.armed) {
+            poll_remove(fd, st);
+        }
+
+        st.gen++;
+        st.events = want;
+        st.armed  = true;
+        if (want == EPOLLIN) {
+            poll_add(fd, POLLIN, tag(fd, st.gen, TAG_IN));
+        } else {
+            poll_add(fd, POLLOUT, tag(fd, st.gen, TAG_OUT));
+        }
+        return true;
+    }
+
+    void idle(int fd) noexcept override {
+        if (fd < 0 || static_cast<size_t>(fd) >= fds_.size()) {
+            return;
+        }
+
+        // Cancel a pending poll: it pins the socket, which the pool may close next
+        fd_state& st = fds_[fd];
+        if (st.armed) {
+            poll_remove(fd, st);
+        }
+        st.gen++;  // Completions still in flight for the old poll are ignored
+        st.op = nullptr;
+    }
+
+private:
+    /** Poll state of one descriptor. */
+    struct fd_state {
+        io_op* op       = nullptr;  // Armed waiter, if any
+        uint32_t events = 0;        // EPOLLIN or EPOLLOUT of the pending poll
+        uint32_t gen    = 0;        // Generation of the pending poll
+        bool armed      = false;    // One-shot poll pending in the kernel
+    };
+
+    static constexpr uint64_t TAG_IN     = 1;
+    static constexpr uint64_t TAG_OUT    = 2;
+    static constexpr uint64_t TAG_CANCEL = 3;
+    static constexpr uint64_t WAKE_TAG   = ~0ULL;
+
+    static uint64_t tag(int fd, uint32_t gen, uint64_t kind) noexcept {
+        return (static_cast<uint64_t>(gen) << 32) | (static_cast<uint64_t>(static_cast<uint32_t>(fd)) << 2) | kind;
+    }
+
+    static int setup(unsigned entries, io_uring_params* params) noexcept {
+        return static_cast<int>(syscall(__NR_io_uring_setup, entries, params));
+    }
+
+    /** Publishes queued submissions and optionally waits; counts as one syscall. */
+    int enter(unsigned min_complete, unsigned flags) noexcept {
+        __atomic_store_n(sq_tail_, sq_local_, __ATOMIC_RELEASE);
+        syscalls_++;
+
+        int rc = static_cast<int>(
+            syscall(__NR_io_uring_enter, ring_fd_, to_submit_, min_complete, flags, nullptr, 0));
+        if (rc > 0) {
+            to_submit_ -= static_cast<unsigned>(rc);
+        }
+        return rc;
+    }
+
+    /** Claims a zeroed submission queue entry, flushing the queue first if it is full. */
+    io_uring_sqe* next_sqe() noexcept {
+        while (sq_local_ - __atomic_load_n(sq_head_, __ATOMIC_ACQUIRE) >= sq_size_) {
+            enter(0, 0);
+        }
+
+        unsigned index    = sq_local_ & sq_mask_;
+        io_uring_sqe* sqe = &sqes_[index];
+        std::memset(sqe, 0, sizeof(*sqe));
+        sq_array_[index] = index;
+        sq_local_++;
+        to_submit_++;
+        return sqe;
+    }
+
+    void poll_add(int fd, uint32_t poll_events, uint64_t user_data, uint32_t flags = 0) noexcept {
+        io_uring_sqe* sqe = next_sqe();
+        sqe->opcode       = IORING_OP_POLL_ADD;
+        sqe->fd           = fd;
+        sqe->len          = flags;
+#if __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+        poll_events = (poll_events << 16) | (poll_events >> 16);
+#endif
+        sqe->poll32_events = poll_events;
+        sqe->user_data     = user_data;
+    }
+
+    /** Cancels the pending poll of a descriptor; its completion is ignored. */
+    void poll_remove(int fd, fd_state& st) noexcept {
+        io_uring_sqe* sqe = next_sqe();
+        sqe->opcode       = IORING_OP_POLL_REMOVE;
+        sqe->fd           = -1;
+        sqe->addr         = tag(fd, st.gen, (st.events & EPOLLIN) ? TAG_IN : TAG_OUT);
+        sqe->user_data    = tag(fd, st.gen, TAG_CANCEL);
+        st.armed          = false;
+    }
+
+    /** Handles every completion currently in the queue. */
+    void reap() {
+        unsigned head = *cq_head_;
+        while (head != __atomic_load_n(cq_tail_, __ATOMIC_ACQUIRE)) {
+            io_uring_cqe cqe = cqes_[head & cq_mask_];
+            __atomic_store_n(cq_head_, ++head, __ATOMIC_RELEASE);  // Free the slot before handlers submit more
+            complete(cqe);
+            head = *cq_head_;
+        }
+    }
+
+    void complete(const io_uring_cqe& cqe) {
+        bool more = cqe.flags & IORING_CQE_F_MORE;
+
+        if (cqe.user_data == WAKE_TAG) {
+            if (cqe.res == -EINVAL) {
+                multishot_ = false;  // Kernel before 5.13
+            }
+            drain_posted();
+            if (!more) {
+                poll_add(wake_fd(), POLLIN, WAKE_TAG, multishot_ ? IORING_POLL_ADD_MULTI : 0);
+            }
+            return;
+        }
+
+        uint64_t kind = cqe.user_data & 3;
+        int fd        = static_cast<int>((cqe.user_data >> 2) & 0x3FFFFFFF);
+        auto gen      = static_cast<uint32_t>(cqe.user_data >> 32);
+        if (kind == TAG_CANCEL || static_cast<size_t>(fd) >= fds_.size() || fds_[fd].gen != gen) {
+            return;  // Stale completion of a poll that was cancelled or replaced
+        }
+
+        // Errors are delivered too: pgconn_poll() surfaces them from the socket
+        fds_[fd].armed = false;
+        deliver(fd);
+    }
+
+    void deliver(int fd) {
+        io_op* op = fds_[fd].op;
+        if (op) {
+            fds_[fd].op = nullptr;
+            op->on_ready(op);
+        }
+    }
+
+    int ring_fd_         = -1;
+    void* ring_          = nullptr;
+    size_t ring_size_    = 0;
+    size_t sqes_size_    = 0;
+    unsigned* sq_head_   = nullptr;
+    unsigned* sq_tail_   = nullptr;
+    unsigned* sq_array_  = nullptr;
+    unsigned sq_mask_    = 0;
+    unsigned sq_size_    = 0;
+    unsigned sq_local_   = 0;  // Tail including entries not yet published
+    unsigned to_submit_  = 0;  // Entries published to the kernel on the next enter()
+    unsigned* cq_head_   = nullptr;
+    unsigned* cq_tail_   = nullptr;
+    unsigned cq_mask_    = 0;
+    io_uring_cqe* cqes_  = nullptr;
+    io_uring_sqe* sqes_  = nullptr;
+    bool multishot_      = true;   // Wake descriptor only; cleared on kernels before 5.13
+    std::vector<fd_state> fds_;  // Indexed by descriptor
+};
+
+}  // namespace pgconn_coro
+
+#endif  // PGCONN_URING_HPP
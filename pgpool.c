@@ -0,0 +1,1406 @@
+#include "pgpool.h"
+#include "pgconn_internal.h"
+
+#include <errno.h>
+#include <poll.h>
+#include <pthread.h>
+#include <sched.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+// Error message buffer capacity
+#define PGPOOL_ERR_CAPACITY 256
+
+// Cache line size used to keep hot atomics apart
+#define PGPOOL_CACHE_LINE 64
+
+// Empty marker for slot indexes (stack links store index + 1)
+#define PGPOOL_NIL 0u
+
+// Consecutive connection failures that open the circuit breaker by default
+#define PGPOOL_BREAKER_THRESHOLD 5
+
+// Maintenance thread interval when only idle_timeout_s or max_lifetime_s is set
+#define PGPOOL_MAINTENANCE_INTERVAL_MS 1000
+
+// Connection lifetimes are shortened by a random amount of up to 1/N of max_lifetime_s
+#define PGPOOL_LIFETIME_JITTER_DIVISOR 10
+
+// Last pool error, tracked per thread since a pool is shared.
+static __thread char tls_pool_error[PGPOOL_ERR_CAPACITY];
+
+// Live pools with thread_affinity. An exiting thread's key destructor looks its
+// slot up here instead of dereferencing it, since the pool may already be freed.
+static pthread_mutex_t affinity_pools_lock = PTHREAD_MUTEX_INITIALIZER;
+static pgconn_pool_t* affinity_pools;  // Linked through affinity_next
+
+/**
+ * Per-connection pool bookkeeping.
+ * A slot is on exactly one of the two stacks (idle or empty) unless its
+ * connection is checked out, being opened or parked for its last thread.
+ */
+typedef struct {
+    _Alignas(PGPOOL_CACHE_LINE) pgconn_t* conn;  // Connection owned by this slot, NULL when empty
+    uint32_t next;                               // Next slot on the same stack (index + 1), atomic
+    bool parked;                                 // Idle and reserved for the thread that released it (atomic)
+} pool_slot_t;
+
+/**
+ * Lock-free LIFO of slot indexes (Treiber stack).
+ * The head packs a 32-bit ABA tag above the top slot's index + 1.
+ */
+typedef struct {
+    _Alignas(PGPOOL_CACHE_LINE) uint64_t head;
+} slot_stack_t;
+
+/** Role of a node in a multi-node pool. */
+typedef enum {
+    NODE_UNKNOWN = 0,  // Not reachable yet, or lost; probed again when needed
+    NODE_PRIMARY,      // Accepts writes
+    NODE_REPLICA,      // Hot standby, read-only
+} node_role_t;
+
+/** One server of a multi-node pool, with its own sub-pool. */
+typedef struct {
+    _Alignas(PGPOOL_CACHE_LINE) pgconn_pool_t* pool;  // Sub-pool of connections to this node
+    uint32_t role;                                    // node_role_t (atomic)
+    size_t outstanding;                               // Connections checked out from this node (atomic)
+    uint64_t next_probe_ns;                           // CLOCK_MONOTONIC time a probe may run again (atomic)
+    uint32_t probe_failures;                          // Consecutive failed probes, scales the backoff (atomic)
+} pool_node_t;
+
+/** Connection pool structure. */
+struct pgconn_pool {
+    slot_stack_t idle;            // Slots holding an idle connection
+    slot_stack_t empty;           // Slots without a connection (room to grow)
+    pool_slot_t* slots;           // Slot storage (capacity max_size)
+    size_t total;                 // Open connections, including ones being created (atomic)
+    size_t waiting;               // Threads in the slow path of pgconn_pool_acquire() (atomic)
+    bool closed;                  // Set by pgconn_pool_destroy() (atomic)
+    pthread_mutex_t lock;         // Slow path only: guards the wait on `available`
+    pthread_cond_t available;     // Signaled when a connection is released or a slot frees up
+    pthread_cond_t maintenance_wake;  // Signaled by pgconn_pool_destroy() to stop the maintenance thread
+    pthread_t maintenance_thread;     // Background validator and reaper (see maintenance_interval_ms())
+    bool maintenance_running;         // maintenance_thread was started
+    pool_slot_t** maintenance_batch;  // Slots checked by maintain_idle() in the current round (capacity max_size)
+    double warmup_ms;             // Duration of the warm-up in pgconn_pool_create()
+    uint32_t breaker_state;       // pgconn_breaker_state_t (atomic)
+    uint32_t breaker_failures;    // Consecutive failures to open a connection (atomic)
+    uint32_t breaker_trips;       // Times reopened since last closed, scales the open period (atomic)
+    uint64_t breaker_until_ns;    // CLOCK_MONOTONIC time a probe is allowed, UINT64_MAX unless open (atomic)
+    pthread_key_t affinity_key;   // Calling thread's preferred slot (thread_affinity only)
+    pgconn_pool_t* affinity_next; // Next pool on affinity_pools (guarded by affinity_pools_lock)
+    pool_node_t* nodes;           // Sub-pools of a multi-node pool (NULL for a single node)
+    size_t n_nodes;               // Number of entries in nodes
+    pgconn_pool_config_t config;  // Configuration (with copied strings and statements)
+};
+
+// === Internal Helper Functions ===
+
+/** Sets the calling thread's pool error message. */
+static void set_pool_error(const char* message) {
+    snprintf(tls_pool_error, sizeof(tls_pool_error), "%s", message ? message : "");
+}
+
+/** Computes an absolute CLOCK_MONOTONIC deadline timeout_ms from now. */
+static struct timespec deadline_after(int timeout_ms) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+
+    ts.tv_sec += timeout_ms / 1000;
+    ts.tv_nsec += (long)(timeout_ms % 1000) * 1000000L;
+    if (ts.tv_nsec >= 1000000000L) {
+        ts.tv_sec++;
+        ts.tv_nsec -= 1000000000L;
+    }
+
+    return ts;
+}
+
+/** Pushes a slot onto a stack. */
+static void stack_push(pgconn_pool_t* pool, slot_stack_t* stack, pool_slot_t* slot) {
+    uint32_t link = (uint32_t)(slot - pool->slots) + 1;
+    uint64_t head = __atomic_load_n(&stack->head, __ATOMIC_RELAXED);
+    uint64_t next_head;
+
+    do {
+        __atomic_store_n(&slot->next, (uint32_t)head, __ATOMIC_RELAXED);
+        next_head = (((head >> 32) + 1) << 32) | link;
+    } while (!__atomic_compare_exchange_n(&stack->head, &head, next_head, true, __ATOMIC_SEQ_CST, __ATOMIC_RELAXED));
+}
+
+/** Pops a slot from a stack, or returns NULL when it is empty. */
+static pool_slot_t* stack_pop(pgconn_pool_t* pool, slot_stack_t* stack) {
+    uint64_t head = __atomic_load_n(&stack->head, __ATOMIC_ACQUIRE);
+    uint64_t next_head;
+    uint32_t link;
+
+    do {
+        link = (uint32_t)head;
+        if (link == PGPOOL_NIL) {
+            return NULL;
+        }
+
+        // Slots are never freed while the pool lives, so a stale read is harmless:
+        // the tag makes the CAS fail if the top changed in between.
+        uint32_t next = __atomic_load_n(&pool->slots[link - 1].next, __ATOMIC_RELAXED);
+        next_head     = (((head >> 32) + 1) << 32) | next;
+    } while (!__atomic_compare_exchange_n(&stack->head, &head, next_head, true, __ATOMIC_SEQ_CST, __ATOMIC_ACQUIRE));
+
+    return &pool->slots[link - 1];
+}
+
+/** Wakes one thread blocked in the acquire slow path, if any. */
+static void notify_waiter(pgconn_pool_t* pool) {
+    // Pairs with the increment in wait_for_slot(): either the waiter sees the
+    // pushed slot on its retry, or we see it waiting and signal under the lock.
+    if (__atomic_load_n(&pool->waiting, __ATOMIC_SEQ_CST) == 0) {
+        return;
+    }
+
+    pthread_mutex_lock(&pool->lock);
+    pthread_cond_signal(&pool->available);
+    pthread_mutex_unlock(&pool->lock);
+}
+
+/** Current CLOCK_MONOTONIC time in nanoseconds. */
+static uint64_t monotonic_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+}
+
+/**
+ * Decides whether a new connection may be opened. While the breaker is open,
+ * callers fail fast; once the open period ends, exactly one caller wins the
+ * CAS on the deadline, moves the breaker to half-open and probes the database.
+ */
+static bool breaker_allow(pgconn_pool_t* pool) {
+    if (!pool->config.conn_config.auto_reconnect) {
+        return true;
+    }
+
+    uint32_t state = __atomic_load_n(&pool->breaker_state, __ATOMIC_ACQUIRE);
+    if (state == PGCONN_BREAKER_CLOSED) {
+        return true;
+    }
+
+    if (state != PGCONN_BREAKER_OPEN) {
+        return false;
+    }
+
+    // The CAS on the deadline picks the single prober; UINT64_MAX makes every
+    // other caller fail fast until the probe's outcome is recorded.
+    uint64_t until = __atomic_load_n(&pool->breaker_until_ns, __ATOMIC_ACQUIRE);
+    if (monotonic_ns() >= until &&
+        __atomic_compare_exchange_n(
+            &pool->breaker_until_ns, &until, UINT64_MAX, false, __ATOMIC_ACQ_REL, __ATOMIC_RELAXED)) {
+        __atomic_store_n(&pool->breaker_state, PGCONN_BREAKER_HALF_OPEN, __ATOMIC_RELEASE);
+        return true;
+    }
+
+    return false;
+}
+
+/** Feeds the outcome of a connection attempt into the breaker. */
+static void breaker_record(pgconn_pool_t* pool, bool success) {
+    if (!pool->config.conn_config.auto_reconnect) {
+        return;
+    }
+
+    if (success) {
+        __atomic_store_n(&pool->breaker_failures, 0, __ATOMIC_RELAXED);
+        __atomic_store_n(&pool->breaker_trips, 0, __ATOMIC_RELAXED);
+        __atomic_store_n(&pool->breaker_until_ns, UINT64_MAX, __ATOMIC_RELAXED);
+        __atomic_store_n(&pool->breaker_state, PGCONN_BREAKER_CLOSED, __ATOMIC_RELEASE);
+        return;
+    }
+
+    const pgconn_config_t* cc = &pool->config.conn_config;
+
+    uint32_t threshold = cc->max_reconnect_attempts > 0 ? (uint32_t)cc->max_reconnect_attempts
+                                                        : PGPOOL_BREAKER_THRESHOLD;
+    uint32_t failures  = __atomic_add_fetch(&pool->breaker_failures, 1, __ATOMIC_RELAXED);
+    uint32_t state     = __atomic_load_n(&pool->breaker_state, __ATOMIC_ACQUIRE);
+
+    if (state == PGCONN_BREAKER_OPEN || (state == PGCONN_BREAKER_CLOSED && failures < threshold)) {
+        return;
+    }
+
+    // Trip (or re-trip after a failed probe). Of several concurrent failures,
+    // only the one that moves the state to OPEN counts the trip. Until it
+    // stores the new period, breaker_until_ns is still UINT64_MAX, so no
+    // probe can start early.
+    if (!__atomic_compare_exchange_n(
+            &pool->breaker_state, &state, PGCONN_BREAKER_OPEN, false, __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE)) {
+        return;
+    }
+
+    // The open period doubles with each trip
+    uint64_t base  = cc->reconnect_base_delay_ms > 0 ? (uint64_t)cc->reconnect_base_delay_ms
+                                                     : PGCONN_RECONNECT_BASE_DELAY_MS;
+    uint64_t max   = cc->reconnect_max_delay_ms > 0 ? (uint64_t)cc->reconnect_max_delay_ms
+                                                    : PGCONN_RECONNECT_MAX_DELAY_MS;
+    uint32_t trips = __atomic_fetch_add(&pool->breaker_trips, 1, __ATOMIC_RELAXED);
+
+    uint64_t open_ms = base;
+    for (uint32_t i = 0; i < trips && open_ms < max; i++) {
+        open_ms *= 2;
+    }
+    if (open_ms > max) {
+        open_ms = max;
+    }
+
+    __atomic_store_n(&pool->breaker_until_ns, monotonic_ns() + open_ms * 1000000ULL, __ATOMIC_RELEASE);
+}
+
+/** Prepares the registered statements on a new connection, one round trip each. */
+static bool prepare_statements(pgconn_pool_t* pool, pgconn_t* conn) {
+    for (size_t i = 0; i < pool->config.n_statements; i++) {
+        const pgconn_pool_statement_t* stmt = &pool->config.statements[i];
+        if (!pgconn_prepare(conn, stmt->name, stmt->query, stmt->n_params, NULL)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/** Assigns an open connection to an empty slot. */
+static void attach_slot(pgconn_pool_t* pool, pool_slot_t* slot, pgconn_t* conn) {
+    slot->conn = conn;
+    pgconn_set_pool_slot(conn, slot);
+    __atomic_add_fetch(&pool->total, 1, __ATOMIC_RELAXED);
+}
+
+/** Opens a connection into an empty slot. Returns NULL and frees the slot on failure. */
+static pgconn_t* fill_slot(pgconn_pool_t* pool, pool_slot_t* slot) {
+    if (!breaker_allow(pool)) {
+        set_pool_error("Circuit breaker open: database unavailable");
+        stack_push(pool, &pool->empty, slot);
+        notify_waiter(pool);
+        return NULL;
+    }
+
+    pgconn_t* conn = pgconn_create(&pool->config.conn_config);
+    breaker_record(pool, conn != NULL);
+
+    if (!conn || !prepare_statements(pool, conn)) {
+        set_pool_error(conn ? pgconn_error_message(conn) : "Failed to open a new pool connection");
+        pgconn_destroy(conn);
+        stack_push(pool, &pool->empty, slot);
+        notify_waiter(pool);
+        return NULL;
+    }
+
+    attach_slot(pool, slot, conn);
+    return conn;
+}
+
+/** Closes a slot's connection and makes the slot available for growth again. */
+static void discard_slot(pgconn_pool_t* pool, pool_slot_t* slot) {
+    pgconn_destroy(slot->conn);
+    slot->conn = NULL;
+    __atomic_sub_fetch(&pool->total, 1, __ATOMIC_RELAXED);
+
+    stack_push(pool, &pool->empty, slot);
+    notify_waiter(pool);
+}
+
+/** Claims a parked slot. Only one of the racing threads succeeds. */
+static bool unpark_slot(pool_slot_t* slot) {
+    bool parked = true;
+    return __atomic_compare_exchange_n(&slot->parked, &parked, false, false, __ATOMIC_ACQUIRE, __ATOMIC_RELAXED);
+}
+
+/** Takes a connection parked by another thread. Only used once the pool is otherwise exhausted. */
+static pool_slot_t* steal_parked(pgconn_pool_t* pool) {
+    for (size_t i = 0; i < pool->config.max_size; i++) {
+        pool_slot_t* slot = &pool->slots[i];
+        if (__atomic_load_n(&slot->parked, __ATOMIC_RELAXED) && unpark_slot(slot)) {
+            return slot;
+        }
+    }
+    return NULL;
+}
+
+/**
+ * Destructor of affinity_key, run when a thread exits: hands the connection
+ * parked for that thread to everyone else instead of leaving it reserved
+ * until the pool runs out and steals it.
+ *
+ * The slot is only touched once it is found in a pool still on
+ * affinity_pools; pgconn_pool_destroy() unlists the pool under the same lock
+ * before it frees anything, so a destructor racing with it either finishes
+ * first or leaves the slot alone.
+ */
+static void release_affinity(void* value) {
+    pool_slot_t* slot = value;
+
+    pthread_mutex_lock(&affinity_pools_lock);
+    for (pgconn_pool_t* pool = affinity_pools; pool; pool = pool->affinity_next) {
+        if (slot >= pool->slots && slot < pool->slots + pool->config.max_size) {
+            if (unpark_slot(slot)) {
+                stack_push(pool, &pool->idle, slot);
+                notify_waiter(pool);
+            }
+            break;
+        }
+    }
+    pthread_mutex_unlock(&affinity_pools_lock);
+}
+
+/** Removes a pool from affinity_pools; exiting threads leave its slots alone from then on. */
+static void unlist_affinity_pool(pgconn_pool_t* pool) {
+    pthread_mutex_lock(&affinity_pools_lock);
+    for (pgconn_pool_t** link = &affinity_pools; *link; link = &(*link)->affinity_next) {
+        if (*link == pool) {
+            *link = pool->affinity_next;
+            break;
+        }
+    }
+    pthread_mutex_unlock(&affinity_pools_lock);
+}
+
+/**
+ * Takes an idle slot or, failing that, an empty one. Never blocks.
+ * Sets *is_empty to tell the caller whether it must open a connection.
+ *
+ * With thread_affinity, the calling thread's parked connection comes first,
+ * and other threads' parked connections are stolen only when the pool can
+ * neither hand out an idle connection nor grow.
+ */
+static pool_slot_t* try_take_slot(pgconn_pool_t* pool, bool* is_empty) {
+    *is_empty = false;
+
+    if (pool->config.thread_affinity) {
+        pool_slot_t* own = pthread_getspecific(pool->affinity_key);
+        if (own && unpark_slot(own)) {
+            return own;
+        }
+    }
+
+    pool_slot_t* slot = stack_pop(pool, &pool->idle);
+    if (slot) {
+        return slot;
+    }
+
+    slot = stack_pop(pool, &pool->empty);
+    if (slot) {
+        *is_empty = true;
+        return slot;
+    }
+
+    return pool->config.thread_affinity ? steal_parked(pool) : NULL;
+}
+
+/**
+ * Slow path: blocks until a slot can be taken or the deadline passes.
+ * Returns NULL on timeout or when the pool is closed.
+ */
+static pool_slot_t* wait_for_slot(pgconn_pool_t* pool, int timeout_ms, const struct timespec* deadline,
+                                  bool* is_empty) {
+    pool_slot_t* slot = NULL;
+
+    pthread_mutex_lock(&pool->lock);
+    __atomic_add_fetch(&pool->waiting, 1, __ATOMIC_SEQ_CST);
+
+    while (!__atomic_load_n(&pool->closed, __ATOMIC_ACQUIRE)) {
+        slot = try_take_slot(pool, is_empty);
+        if (slot) {
+            break;
+        }
+
+        int rc;
+        if (timeout_ms < 0) {
+            rc = pthread_cond_wait(&pool->available, &pool->lock);
+        } else {
+            rc = pthread_cond_timedwait(&pool->available, &pool->lock, deadline);
+        }
+
+        if (rc == ETIMEDOUT) {
+            // One last look: a release may have raced with the timeout
+            slot = try_take_slot(pool, is_empty);
+            if (!slot) {
+                set_pool_error("Timed out waiting for a pool connection");
+            }
+            break;
+        }
+    }
+
+    bool closed = __atomic_load_n(&pool->closed, __ATOMIC_ACQUIRE);
+    pthread_mutex_unlock(&pool->lock);
+
+    // Decrement only after unlocking: pgconn_pool_destroy() waits for zero
+    // before destroying the mutex.
+    __atomic_sub_fetch(&pool->waiting, 1, __ATOMIC_SEQ_CST);
+
+    if (!slot && closed) {
+        set_pool_error("Pool is closed");
+    }
+
+    return slot;
+}
+
+/** Frees the pool's copy of the registered statements. */
+static void free_statements(pgconn_pool_t* pool) {
+    pgconn_pool_statement_t* stmts = (pgconn_pool_statement_t*)pool->config.statements;
+    for (size_t i = 0; stmts && i < pool->config.n_statements; i++) {
+        free((void*)stmts[i].name);
+        free((void*)stmts[i].query);
+    }
+    free(stmts);
+    pool->config.statements   = NULL;
+    pool->config.n_statements = 0;
+}
+
+/** Copies the registered statements so the caller's array need not outlive the pool. */
+static bool copy_statements(pgconn_pool_t* pool, const pgconn_pool_config_t* config) {
+    pool->config.statements   = NULL;
+    pool->config.n_statements = 0;
+    if (config->n_statements == 0 || !config->statements) {
+        return true;
+    }
+
+    pgconn_pool_statement_t* stmts = calloc(config->n_statements, sizeof(pgconn_pool_statement_t));
+    if (!stmts) {
+        return false;
+    }
+    pool->config.statements   = stmts;
+    pool->config.n_statements = config->n_statements;
+
+    for (size_t i = 0; i < config->n_statements; i++) {
+        const pgconn_pool_statement_t* src = &config->statements[i];
+        if (!src->name || !src->query) {
+            fprintf(stderr, "pgconn: pool statement %zu needs a name and a query\n", i);
+            return false;
+        }
+
+        stmts[i].name     = strdup(src->name);
+        stmts[i].query    = strdup(src->query);
+        stmts[i].n_params = src->n_params;
+        if (!stmts[i].name || !stmts[i].query) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * Sends every registered statement to a fresh connection in one pipeline.
+ * Returns false if pipelining is unavailable; the caller then prepares serially.
+ */
+static bool send_statements(pgconn_pool_t* pool, pgconn_t* conn) {
+    if (!pgconn_pipeline_begin(conn)) {
+        return false;
+    }
+
+    for (size_t i = 0; i < pool->config.n_statements; i++) {
+        const pgconn_pool_statement_t* stmt = &pool->config.statements[i];
+        pgconn_pipeline_send_prepare(conn, stmt->name, stmt->query, stmt->n_params, NULL);
+    }
+    pgconn_pipeline_sync(conn);
+    return true;
+}
+
+/** Reads the results of send_statements(). */
+static bool finish_statements(pgconn_pool_t* pool, pgconn_t* conn) {
+    size_t prepared = 0;
+    PGresult* res;
+    while ((res = pgconn_pipeline_next_result(conn, NULL)) != NULL) {
+        if (PQresultStatus(res) == PGRES_COMMAND_OK) {
+            prepared++;
+        }
+        PQclear(res);
+    }
+
+    return pgconn_pipeline_end(conn) && prepared == pool->config.n_statements;
+}
+
+/**
+ * Opens `count` connections concurrently, prepares the registered statements
+ * on all of them in parallel and pushes them onto the idle stack.
+ */
+static bool warm_up(pgconn_pool_t* pool, size_t count) {
+    pgconn_t** conns              = calloc(count, sizeof(pgconn_t*));
+    pgconn_poll_status_t* status  = calloc(count, sizeof(pgconn_poll_status_t));
+    bool* pipelined               = calloc(count, sizeof(bool));
+    struct pollfd* pfds           = calloc(count, sizeof(struct pollfd));
+    size_t* owners                = calloc(count, sizeof(size_t));
+    bool ok                       = conns && status && pipelined && pfds && owners;
+
+    // Start every handshake, then drive them all from one poll() loop
+    for (size_t i = 0; ok && i < count; i++) {
+        conns[i]  = pgconn_connect_start(&pool->config.conn_config);
+        status[i] = PGCONN_POLL_WRITING;
+        ok        = conns[i] != NULL;
+    }
+
+    size_t pending = ok ? count : 0;
+    while (ok && pending > 0) {
+        nfds_t n_fds = 0;
+        for (size_t i = 0; i < count; i++) {
+            if (status[i] == PGCONN_POLL_READING || status[i] == PGCONN_POLL_WRITING) {
+                pfds[n_fds].fd      = pgconn_socket(conns[i]);
+                pfds[n_fds].events  = status[i] == PGCONN_POLL_READING ? POLLIN : POLLOUT;
+                pfds[n_fds].revents = 0;
+                owners[n_fds++]     = i;
+            }
+        }
+
+        // Wake up at least once a second so connect_timeout is enforced
+        int timeout = pool->config.conn_config.connect_timeout > 0 ? 1000 : -1;
+        if (poll(pfds, n_fds, timeout) < 0 && errno != EINTR) {
+            ok = false;
+            break;
+        }
+
+        // pgconn_connect_poll() checks readiness itself, so polling every pending connection is safe
+        for (nfds_t k = 0; k < n_fds; k++) {
+            size_t i  = owners[k];
+            status[i] = pgconn_connect_poll(conns[i]);
+
+            if (status[i] == PGCONN_POLL_FAILED) {
+                fprintf(stderr,
+                        "pgconn: Failed to open pool connection %zu of %zu: %s\n",
+                        i + 1,
+                        count,
+                        pgconn_error_message(conns[i]));
+                ok = false;
+            } else if (status[i] == PGCONN_POLL_DONE) {
+                pending--;
+            }
+        }
+    }
+
+    if (ok && pool->config.n_statements > 0) {
+        // Put every connection's prepares on the wire before waiting for any of them
+        for (size_t i = 0; i < count; i++) {
+            pipelined[i] = send_statements(pool, conns[i]);
+        }
+
+        for (size_t i = 0; i < count; i++) {
+            bool prepared = pipelined[i] ? finish_statements(pool, conns[i]) : prepare_statements(pool, conns[i]);
+            if (!prepared && ok) {
+                fprintf(stderr, "pgconn: Failed to prepare pool statements: %s\n", pgconn_error_message(conns[i]));
+                ok = false;
+            }
+        }
+    }
+
+    for (size_t i = 0; conns && i < count; i++) {
+        if (ok) {
+            pool_slot_t* slot = stack_pop(pool, &pool->empty);
+            attach_slot(pool, slot, conns[i]);
+            stack_push(pool, &pool->idle, slot);
+        } else {
+            pgconn_destroy(conns[i]);
+        }
+    }
+
+    free(conns);
+    free(status);
+    free(pipelined);
+    free(pfds);
+    free(owners);
+    return ok;
+}
+
+/**
+ * Checks whether a connection has outlived max_lifetime_s. Each connection's
+ * limit is cut by a stable pseudo-random share of up to 1/10, so connections
+ * opened together are not all replaced at the same moment.
+ */
+static bool lifetime_expired(pgconn_pool_t* pool, pgconn_t* conn, time_t now) {
+    int max_lifetime_s = pool->config.max_lifetime_s;
+    if (max_lifetime_s <= 0) {
+        return false;
+    }
+
+    // splitmix64 finalizer: spreads sequential connection ids evenly
+    uint64_t x = pgconn_connection_id(conn) + 0x9E3779B97F4A7C15ULL;
+    x          = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    x          = (x ^ (x >> 27)) * 0x94D049BB133111EBULL;
+    x ^= x >> 31;
+
+    time_t jitter = (time_t)(x % ((uint64_t)max_lifetime_s / PGPOOL_LIFETIME_JITTER_DIVISOR + 1));
+    return now - pgconn_created_at(conn) >= max_lifetime_s - jitter;
+}
+
+/**
+ * Decides whether a claimed idle connection stays in the pool, closing it if
+ * not: it is retired past its lifetime, reaped after idle_timeout_s while the
+ * pool is above min_size, and validated when validate_interval_ms is set.
+ */
+static bool keep_idle(pgconn_pool_t* pool, pool_slot_t* slot, time_t now) {
+    const pgconn_pool_config_t* config = &pool->config;
+    pgconn_t* conn                     = slot->conn;
+
+    bool keep = !lifetime_expired(pool, conn, now);
+    if (keep && config->idle_timeout_s > 0 && now - pgconn_last_activity(conn) >= config->idle_timeout_s &&
+        __atomic_load_n(&pool->total, __ATOMIC_RELAXED) > config->min_size) {
+        keep = false;
+    }
+    if (keep && config->validate_interval_ms > 0) {
+        keep = pgconn_validate_fast(conn, config->validate_idle_s);
+    }
+
+    if (!keep) {
+        discard_slot(pool, slot);
+    }
+    return keep;
+}
+
+/**
+ * Runs keep_idle() on every idle connection once. Parked connections are
+ * claimed and re-parked one at a time. Connections on the shared stack are
+ * popped and checked one at a time; those kept are held aside until the round
+ * ends and then pushed back in their original order with a single wake-up,
+ * so a round costs O(n) and every unchecked connection stays available to
+ * acquirers while another is being validated.
+ */
+static void maintain_idle(pgconn_pool_t* pool) {
+    time_t now = time(NULL);
+
+    for (size_t i = 0; pool->config.thread_affinity && i < pool->config.max_size; i++) {
+        pool_slot_t* slot = &pool->slots[i];
+        if (!__atomic_load_n(&slot->parked, __ATOMIC_RELAXED) || !unpark_slot(slot)) {
+            continue;
+        }
+
+        if (keep_idle(pool, slot, now)) {
+            __atomic_store_n(&slot->parked, true, __ATOMIC_SEQ_CST);
+            notify_waiter(pool);
+        }
+    }
+
+    // Each slot is held aside at most once, so the batch never exceeds max_size
+    size_t n_checked = 0;
+    pool_slot_t* slot;
+    while (n_checked < pool->config.max_size && !__atomic_load_n(&pool->closed, __ATOMIC_ACQUIRE) &&
+           (slot = stack_pop(pool, &pool->idle)) != NULL) {
+        if (keep_idle(pool, slot, now)) {
+            pool->maintenance_batch[n_checked++] = slot;
+        }
+    }
+    if (n_checked == 0) {
+        return;
+    }
+
+    // Popped from the top down, so pushing in reverse restores the order
+    for (size_t i = n_checked; i-- > 0;) {
+        stack_push(pool, &pool->idle, pool->maintenance_batch[i]);
+    }
+    if (__atomic_load_n(&pool->waiting, __ATOMIC_SEQ_CST) > 0) {
+        pthread_mutex_lock(&pool->lock);
+        pthread_cond_broadcast(&pool->available);
+        pthread_mutex_unlock(&pool->lock);
+    }
+}
+
+/** Opens connections until the pool is back at min_size, e.g. after retiring old ones. */
+static void replenish(pgconn_pool_t* pool) {
+    while (__atomic_load_n(&pool->total, __ATOMIC_RELAXED) < pool->config.min_size &&
+           !__atomic_load_n(&pool->closed, __ATOMIC_ACQUIRE)) {
+        pool_slot_t* slot = stack_pop(pool, &pool->empty);
+        if (!slot || !fill_slot(pool, slot)) {
+            return;  // At max_size, or the database is down: try again next round
+        }
+
+        stack_push(pool, &pool->idle, slot);
+        notify_waiter(pool);
+    }
+}
+
+/** Interval of the maintenance thread, or 0 if the configuration needs none. */
+static int maintenance_interval_ms(const pgconn_pool_config_t* config) {
+    if (config->validate_interval_ms > 0) {
+        return config->validate_interval_ms;
+    }
+    if (config->idle_timeout_s > 0 || config->max_lifetime_s > 0) {
+        return PGPOOL_MAINTENANCE_INTERVAL_MS;
+    }
+    return 0;
+}
+
+/** Background thread: maintains idle connections every interval until the pool is destroyed. */
+static void* maintenance_main(void* arg) {
+    pgconn_pool_t* pool = arg;
+    int interval_ms     = maintenance_interval_ms(&pool->config);
+
+    while (true) {
+        struct timespec deadline = deadline_after(interval_ms);
+
+        pthread_mutex_lock(&pool->lock);
+        while (!__atomic_load_n(&pool->closed, __ATOMIC_ACQUIRE) &&
+               pthread_cond_timedwait(&pool->maintenance_wake, &pool->lock, &deadline) != ETIMEDOUT) {
+        }
+        bool closed = __atomic_load_n(&pool->closed, __ATOMIC_ACQUIRE);
+        pthread_mutex_unlock(&pool->lock);
+
+        if (closed) {
+            return NULL;
+        }
+
+        maintain_idle(pool);
+        replenish(pool);
+    }
+}
+
+/** Checks whether a connection was handed out by this (single-node) pool. */
+static bool owns_connection(pgconn_pool_t* pool, pgconn_t* conn) {
+    pool_slot_t* slot = pgconn_pool_slot(conn);
+    return slot && slot >= pool->slots && slot < pool->slots + pool->config.max_size && slot->conn == conn;
+}
+
+/** Frees pool memory and synchronization objects. */
+static void free_pool(pgconn_pool_t* pool) {
+    // pgconn_pool_destroy() has already deleted the key
+    if (pool->config.thread_affinity && !pool->closed) {
+        unlist_affinity_pool(pool);
+        pthread_key_delete(pool->affinity_key);
+    }
+    pthread_cond_destroy(&pool->maintenance_wake);
+    pthread_cond_destroy(&pool->available);
+    pthread_mutex_destroy(&pool->lock);
+    free_statements(pool);
+    free(pool->maintenance_batch);
+    free((void*)pool->config.conn_config.conninfo);
+    free(pool->slots);
+    free(pool);
+}
+
+// === Multi-Node Routing ===
+
+/**
+ * Role the server reported without a round trip. PostgreSQL 14+ sends
+ * in_hot_standby at startup and again on promotion; older servers send nothing.
+ */
+static node_role_t reported_role(pgconn_t* conn) {
+    const char* hot_standby = PQparameterStatus(pgconn_get_raw(conn), "in_hot_standby");
+    if (!hot_standby) {
+        return NODE_UNKNOWN;
+    }
+    return strcmp(hot_standby, "on") == 0 ? NODE_REPLICA : NODE_PRIMARY;
+}
+
+/** Determines a node's role, asking pg_is_in_recovery() if the server did not report it. */
+static node_role_t detect_role(pgconn_t* conn) {
+    node_role_t role = reported_role(conn);
+    if (role != NODE_UNKNOWN) {
+        return role;
+    }
+
+    PGresult* res = pgconn_query(conn, "SELECT pg_is_in_recovery()", NULL);
+    if (res && PQntuples(res) == 1) {
+        role = PQgetvalue(res, 0, 0)[0] == 't' ? NODE_REPLICA : NODE_PRIMARY;
+    }
+    PQclear(res);
+    return role;
+}
+
+/** Backoff before the next probe of a node, doubling per failed probe from reconnect_base_delay_ms. */
+static uint64_t probe_delay_ns(const pool_node_t* node) {
+    const pgconn_config_t* cc = &node->pool->config.conn_config;
+
+    uint64_t base    = cc->reconnect_base_delay_ms > 0 ? (uint64_t)cc->reconnect_base_delay_ms
+                                                       : PGCONN_RECONNECT_BASE_DELAY_MS;
+    uint64_t max     = cc->reconnect_max_delay_ms > 0 ? (uint64_t)cc->reconnect_max_delay_ms
+                                                      : PGCONN_RECONNECT_MAX_DELAY_MS;
+    uint32_t failed  = __atomic_load_n(&node->probe_failures, __ATOMIC_RELAXED);
+    uint64_t wait_ms = base;
+    for (uint32_t i = 0; i < failed && wait_ms < max; i++) {
+        wait_ms *= 2;
+    }
+    if (wait_ms > max) {
+        wait_ms = max;
+    }
+    return wait_ms * 1000000ULL;
+}
+
+/**
+ * Connects to a node of unknown role (if it has no idle connection) and
+ * records its role. A node that cannot be reached is not probed again until
+ * its backoff ends (doubling from reconnect_base_delay_ms up to
+ * reconnect_max_delay_ms), so callers are not each held up by a connect
+ * timeout during an outage. Only one caller probes a node at a time.
+ */
+static void probe_node(pool_node_t* node) {
+    uint64_t now  = monotonic_ns();
+    uint64_t next = __atomic_load_n(&node->next_probe_ns, __ATOMIC_ACQUIRE);
+    if (now < next) {
+        return;
+    }
+
+    // Claim the probe by pushing the next one out; losers route elsewhere
+    if (!__atomic_compare_exchange_n(
+            &node->next_probe_ns, &next, now + probe_delay_ns(node), false, __ATOMIC_ACQ_REL, __ATOMIC_RELAXED)) {
+        return;
+    }
+
+    pgconn_t* conn   = pgconn_pool_acquire(node->pool, 0);
+    node_role_t role = conn ? detect_role(conn) : NODE_UNKNOWN;
+    if (conn) {
+        pgconn_pool_release(node->pool, conn);
+    }
+
+    if (role == NODE_UNKNOWN) {
+        __atomic_add_fetch(&node->probe_failures, 1, __ATOMIC_RELAXED);
+        return;
+    }
+
+    __atomic_store_n(&node->probe_failures, 0, __ATOMIC_RELAXED);
+    __atomic_store_n(&node->next_probe_ns, 0, __ATOMIC_RELEASE);
+    __atomic_store_n(&node->role, role, __ATOMIC_RELEASE);
+}
+
+/**
+ * Marks a node that could not open any connection as unknown. This counts as
+ * a failed probe, so find_node() does not try it again before its backoff.
+ */
+static void demote_node(pool_node_t* node) {
+    __atomic_store_n(&node->next_probe_ns, monotonic_ns() + probe_delay_ns(node), __ATOMIC_RELEASE);
+    __atomic_add_fetch(&node->probe_failures, 1, __ATOMIC_RELAXED);
+    __atomic_store_n(&node->role, NODE_UNKNOWN, __ATOMIC_RELEASE);
+}
+
+/** Picks the node with the given role that has the fewest connections checked out. */
+static pool_node_t* least_outstanding(pgconn_pool_t* pool, node_role_t role) {
+    pool_node_t* best = NULL;
+    size_t best_load  = SIZE_MAX;
+
+    for (size_t i = 0; i < pool->n_nodes; i++) {
+        pool_node_t* node = &pool->nodes[i];
+        if (__atomic_load_n(&node->role, __ATOMIC_ACQUIRE) != role) {
+            continue;
+        }
+
+        size_t load = __atomic_load_n(&node->outstanding, __ATOMIC_RELAXED);
+        if (load < best_load) {
+            best      = node;
+            best_load = load;
+        }
+    }
+    return best;
+}
+
+/** Like least_outstanding(), but probes nodes of unknown role first when none matches. */
+static pool_node_t* find_node(pgconn_pool_t* pool, node_role_t role) {
+    pool_node_t* node = least_outstanding(pool, role);
+    if (node) {
+        return node;
+    }
+
+    for (size_t i = 0; i < pool->n_nodes; i++) {
+        if (__atomic_load_n(&pool->nodes[i].role, __ATOMIC_ACQUIRE) == NODE_UNKNOWN) {
+            probe_node(&pool->nodes[i]);
+        }
+    }
+    return least_outstanding(pool, role);
+}
+
+/**
+ * Checks out a connection from the best node for the role. A node whose
+ * server reports a different role (after a failover) is reclassified, and a
+ * node that cannot open any connection is marked unknown while the next
+ * candidate is tried. A timeout on a node that is up fails the call.
+ */
+static pgconn_t* acquire_from_nodes(pgconn_pool_t* pool, node_role_t role, int timeout_ms) {
+    // Every node can be reclassified at most once per call
+    for (size_t attempt = 0; attempt <= pool->n_nodes; attempt++) {
+        pool_node_t* node = find_node(pool, role);
+        if (!node && role == NODE_REPLICA) {
+            node = find_node(pool, NODE_PRIMARY);  // No replica: reads go to the primary
+        }
+        if (!node) {
+            set_pool_error(role == NODE_PRIMARY ? "No primary node available" : "No node available");
+            return NULL;
+        }
+
+        __atomic_add_fetch(&node->outstanding, 1, __ATOMIC_RELAXED);
+        pgconn_t* conn = pgconn_pool_acquire(node->pool, timeout_ms);
+        if (!conn) {
+            __atomic_sub_fetch(&node->outstanding, 1, __ATOMIC_RELAXED);
+            if (__atomic_load_n(&node->pool->total, __ATOMIC_RELAXED) > 0) {
+                return NULL;  // The node is up but busy: keep the timeout error
+            }
+            demote_node(node);
+            continue;
+        }
+
+        // Reads may land on a freshly promoted primary, writes never on a replica
+        node_role_t actual = reported_role(conn);
+        if (actual == NODE_UNKNOWN) {
+            return conn;
+        }
+        if (actual != __atomic_load_n(&node->role, __ATOMIC_RELAXED)) {
+            __atomic_store_n(&node->role, actual, __ATOMIC_RELEASE);
+        }
+        if (actual == role || role == NODE_REPLICA) {
+            return conn;
+        }
+
+        __atomic_sub_fetch(&node->outstanding, 1, __ATOMIC_RELAXED);
+        pgconn_pool_release(node->pool, conn);
+    }
+
+    set_pool_error("Node roles kept changing while acquiring a connection");
+    return NULL;
+}
+
+/** Returns a connection to the node it came from. */
+static void release_to_node(pgconn_pool_t* pool, pgconn_t* conn) {
+    for (size_t i = 0; i < pool->n_nodes; i++) {
+        pool_node_t* node = &pool->nodes[i];
+        if (owns_connection(node->pool, conn)) {
+            __atomic_sub_fetch(&node->outstanding, 1, __ATOMIC_RELAXED);
+            pgconn_pool_release(node->pool, conn);
+            return;
+        }
+    }
+    set_pool_error("Connection does not belong to this pool");
+}
+
+/** Frees a multi-node pool and every sub-pool. */
+static void destroy_nodes(pgconn_pool_t* pool) {
+    for (size_t i = 0; i < pool->n_nodes; i++) {
+        pgconn_pool_destroy(pool->nodes[i].pool);
+    }
+    free(pool->nodes);
+    free(pool);
+}
+
+/**
+ * Creates one sub-pool per node and detects every node's role. A node that is
+ * down gets an empty sub-pool and is probed again when a role is missing.
+ */
+static pgconn_pool_t* create_nodes(const pgconn_pool_config_t* config) {
+    pgconn_pool_t* pool = aligned_alloc(PGPOOL_CACHE_LINE, sizeof(pgconn_pool_t));
+    pool_node_t* nodes  = aligned_alloc(PGPOOL_CACHE_LINE, config->n_nodes * sizeof(pool_node_t));
+    if (!pool || !nodes) {
+        fprintf(stderr, "pgconn: Memory allocation failed\n");
+        free(pool);
+        free(nodes);
+        return NULL;
+    }
+    memset(pool, 0, sizeof(*pool));
+    memset(nodes, 0, config->n_nodes * sizeof(pool_node_t));
+
+    // Caller-owned pointers are only needed while the sub-pools copy them
+    pool->config                      = *config;
+    pool->config.conn_config.conninfo = NULL;
+    pool->config.statements           = NULL;
+    pool->config.n_statements         = 0;
+    pool->config.node_conninfos       = NULL;
+    pool->nodes                       = nodes;
+    pool->n_nodes                     = config->n_nodes;
+
+    struct timespec start, end;
+    clock_gettime(CLOCK_MONOTONIC, &start);
+
+    bool any_up = false;
+    for (size_t i = 0; i < config->n_nodes; i++) {
+        pgconn_pool_config_t node_config   = *config;
+        node_config.conn_config.conninfo   = config->node_conninfos[i];
+        node_config.node_conninfos         = NULL;
+        node_config.n_nodes                = 0;
+
+        nodes[i].pool = pgconn_pool_create(&node_config);
+        if (!nodes[i].pool && config->min_size > 0) {
+            node_config.min_size = 0;  // Node is down: open connections lazily once it is back
+            nodes[i].pool        = pgconn_pool_create(&node_config);
+        }
+        if (!nodes[i].pool) {
+            pool->n_nodes = i;
+            destroy_nodes(pool);
+            return NULL;
+        }
+
+        probe_node(&nodes[i]);
+        any_up = any_up || nodes[i].role != NODE_UNKNOWN;
+    }
+
+    if (!any_up) {
+        fprintf(stderr, "pgconn: No node of the pool could be reached\n");
+        destroy_nodes(pool);
+        return NULL;
+    }
+
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    pool->warmup_ms = (double)(end.tv_sec - start.tv_sec) * 1e3 + (double)(end.tv_nsec - start.tv_nsec) / 1e6;
+
+    return pool;
+}
+
+// === Pool Management ===
+
+pgconn_pool_t* pgconn_pool_create(const pgconn_pool_config_t* config) {
+    if (config && config->n_nodes > 0) {
+        if (!config->node_conninfos) {
+            fprintf(stderr, "pgconn: config->node_conninfos must not be NULL when n_nodes is set\n");
+            return NULL;
+        }
+        for (size_t i = 0; i < config->n_nodes; i++) {
+            if (!config->node_conninfos[i]) {
+                fprintf(stderr, "pgconn: node conninfo %zu must not be NULL\n", i);
+                return NULL;
+            }
+        }
+        return create_nodes(config);
+    }
+
+    if (!config || !config->conn_config.conninfo) {
+        fprintf(stderr, "pgconn: config and config->conn_config.conninfo must not be NULL\n");
+        return NULL;
+    }
+
+    size_t max_size = config->max_size ? config->max_size : config->min_size;
+    if (max_size == 0) {
+        max_size = 1;
+    }
+
+    if (config->min_size > max_size) {
+        fprintf(stderr, "pgconn: pool min_size must not exceed max_size\n");
+        return NULL;
+    }
+
+    // Idle stack links are 32-bit slot indexes (index + 1)
+    if (max_size >= UINT32_MAX) {
+        fprintf(stderr, "pgconn: pool max_size must be below %u\n", UINT32_MAX);
+        return NULL;
+    }
+
+    pgconn_pool_t* pool = aligned_alloc(PGPOOL_CACHE_LINE, sizeof(pgconn_pool_t));
+    if (!pool) {
+        fprintf(stderr, "pgconn: Memory allocation failed\n");
+        return NULL;
+    }
+    memset(pool, 0, sizeof(*pool));
+    pool->breaker_until_ns = UINT64_MAX;  // Only meaningful once a trip sets it
+
+    pool->config          = *config;
+    pool->config.max_size = max_size;
+
+    pool->config.conn_config.conninfo = strdup(config->conn_config.conninfo);
+    pool->slots                       = aligned_alloc(PGPOOL_CACHE_LINE, max_size * sizeof(pool_slot_t));
+    if (!pool->config.conn_config.conninfo || !pool->slots) {
+        fprintf(stderr, "pgconn: Memory allocation failed\n");
+        free((void*)pool->config.conn_config.conninfo);
+        free(pool->slots);
+        free(pool);
+        return NULL;
+    }
+    memset(pool->slots, 0, max_size * sizeof(pool_slot_t));
+
+    pthread_condattr_t cond_attr;
+    pthread_condattr_init(&cond_attr);
+    pthread_condattr_setclock(&cond_attr, CLOCK_MONOTONIC);
+
+    if (pthread_mutex_init(&pool->lock, NULL) != 0) {
+        fprintf(stderr, "pgconn: Failed to initialize pool mutex\n");
+        pthread_condattr_destroy(&cond_attr);
+        free((void*)pool->config.conn_config.conninfo);
+        free(pool->slots);
+        free(pool);
+        return NULL;
+    }
+
+    if (pthread_cond_init(&pool->available, &cond_attr) != 0) {
+        fprintf(stderr, "pgconn: Failed to initialize pool condition variable\n");
+        pthread_condattr_destroy(&cond_attr);
+        pthread_mutex_destroy(&pool->lock);
+        free((void*)pool->config.conn_config.conninfo);
+        free(pool->slots);
+        free(pool);
+        return NULL;
+    }
+
+    if (pthread_cond_init(&pool->maintenance_wake, &cond_attr) != 0) {
+        fprintf(stderr, "pgconn: Failed to initialize pool condition variable\n");
+        pthread_condattr_destroy(&cond_attr);
+        pthread_cond_destroy(&pool->available);
+        pthread_mutex_destroy(&pool->lock);
+        free((void*)pool->config.conn_config.conninfo);
+        free(pool->slots);
+        free(pool);
+        return NULL;
+    }
+    pthread_condattr_destroy(&cond_attr);
+
+    if (pool->config.thread_affinity && pthread_key_create(&pool->affinity_key, release_affinity) != 0) {
+        fprintf(stderr, "pgconn: Failed to create pool thread affinity key\n");
+        pool->config.thread_affinity = false;
+        free_pool(pool);
+        return NULL;
+    }
+    if (pool->config.thread_affinity) {
+        pthread_mutex_lock(&affinity_pools_lock);
+        pool->affinity_next = affinity_pools;
+        affinity_pools      = pool;
+        pthread_mutex_unlock(&affinity_pools_lock);
+    }
+
+    if (!copy_statements(pool, config)) {
+        fprintf(stderr, "pgconn: Failed to copy pool statements\n");
+        free_pool(pool);
+        return NULL;
+    }
+
+    if (maintenance_interval_ms(config) > 0 &&
+        !(pool->maintenance_batch = calloc(max_size, sizeof(pool_slot_t*)))) {
+        fprintf(stderr, "pgconn: Memory allocation failed\n");
+        free_pool(pool);
+        return NULL;
+    }
+
+    // Every slot starts empty; push in reverse so slot 0 is used first
+    for (size_t i = max_size; i-- > 0;) {
+        stack_push(pool, &pool->empty, &pool->slots[i]);
+    }
+
+    // Open the minimum number of connections up front, all at once
+    struct timespec start, end;
+    clock_gettime(CLOCK_MONOTONIC, &start);
+
+    if (config->min_size > 0 && !warm_up(pool, config->min_size)) {
+        pgconn_pool_destroy(pool);
+        return NULL;
+    }
+
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    pool->warmup_ms = (double)(end.tv_sec - start.tv_sec) * 1e3 + (double)(end.tv_nsec - start.tv_nsec) / 1e6;
+
+    if (maintenance_interval_ms(config) > 0) {
+        if (pthread_create(&pool->maintenance_thread, NULL, maintenance_main, pool) != 0) {
+            fprintf(stderr, "pgconn: Failed to start pool maintenance thread\n");
+            pgconn_pool_destroy(pool);
+            return NULL;
+        }
+        pool->maintenance_running = true;
+    }
+
+    return pool;
+}
+
+void pgconn_pool_destroy(pgconn_pool_t* pool) {
+    if (!pool) return;
+
+    if (pool->nodes) {
+        destroy_nodes(pool);
+        return;
+    }
+
+    pthread_mutex_lock(&pool->lock);
+    __atomic_store_n(&pool->closed, true, __ATOMIC_RELEASE);
+    pthread_cond_broadcast(&pool->available);
+    pthread_cond_signal(&pool->maintenance_wake);
+    pthread_mutex_unlock(&pool->lock);
+
+    // Exiting threads no longer return parked connections; one already inside
+    // release_affinity() finishes before the pool is unlisted
+    if (pool->config.thread_affinity) {
+        unlist_affinity_pool(pool);
+        pthread_key_delete(pool->affinity_key);
+    }
+
+    // The maintenance thread puts back any connections it is checking before it exits
+    if (pool->maintenance_running) {
+        pthread_join(pool->maintenance_thread, NULL);
+    }
+
+    pool_slot_t* slot;
+    while ((slot = stack_pop(pool, &pool->idle)) != NULL) {
+        pgconn_destroy(slot->conn);
+        slot->conn = NULL;
+    }
+
+    while (pool->config.thread_affinity && (slot = steal_parked(pool)) != NULL) {
+        pgconn_destroy(slot->conn);
+        slot->conn = NULL;
+    }
+
+    // Let threads woken above leave the slow path before tearing down
+    while (__atomic_load_n(&pool->waiting, __ATOMIC_ACQUIRE) > 0) {
+        sched_yield();
+    }
+
+    free_pool(pool);
+}
+
+// === Checkout / Checkin ===
+
+pgconn_t* pgconn_pool_acquire(pgconn_pool_t* pool, int timeout_ms) {
+    if (!pool) {
+        set_pool_error("Invalid pool");
+        return NULL;
+    }
+
+    if (pool->nodes) {
+        return acquire_from_nodes(pool, NODE_PRIMARY, timeout_ms);
+    }
+
+    struct timespec deadline = {0, 0};
+    bool deadline_set        = false;
+
+    while (true) {
+        if (__atomic_load_n(&pool->closed, __ATOMIC_ACQUIRE)) {
+            set_pool_error("Pool is closed");
+            return NULL;
+        }
+
+        // Fast path: two lock-free pops at most
+        bool is_empty;
+        pool_slot_t* slot = try_take_slot(pool, &is_empty);
+
+        if (!slot) {
+            if (timeout_ms == 0) {
+                set_pool_error("Pool exhausted");
+                return NULL;
+            }
+
+            if (timeout_ms > 0 && !deadline_set) {
+                deadline     = deadline_after(timeout_ms);
+                deadline_set = true;
+            }
+
+            slot = wait_for_slot(pool, timeout_ms, &deadline, &is_empty);
+            if (!slot) {
+                return NULL;
+            }
+        }
+
+        // Grow the pool; the connection is opened outside of any lock
+        if (is_empty) {
+            pgconn_t* conn = fill_slot(pool, slot);
+            if (conn && pool->config.thread_affinity) {
+                pthread_setspecific(pool->affinity_key, slot);
+            }
+            return conn;
+        }
+
+        if (!pool->config.validate_on_acquire || pgconn_validate_fast(slot->conn, pool->config.validate_idle_s)) {
+            if (pool->config.thread_affinity) {
+                pthread_setspecific(pool->affinity_key, slot);
+            }
+            return slot->conn;
+        }
+
+        // Stale connection: drop it and try again
+        discard_slot(pool, slot);
+    }
+}
+
+pgconn_t* pgconn_pool_acquire_ro(pgconn_pool_t* pool, int timeout_ms) {
+    if (pool && pool->nodes) {
+        return acquire_from_nodes(pool, NODE_REPLICA, timeout_ms);
+    }
+    return pgconn_pool_acquire(pool, timeout_ms);
+}
+
+void pgconn_pool_release(pgconn_pool_t* pool, pgconn_t* conn) {
+    if (!pool || !conn) return;
+
+    if (pool->nodes) {
+        release_to_node(pool, conn);
+        return;
+    }
+
+    if (!owns_connection(pool, conn)) {
+        set_pool_error("Connection does not belong to this pool");
+        return;
+    }
+    pool_slot_t* slot = pgconn_pool_slot(conn);
+
+    // A connection abandoned with an asynchronous query in flight or in the middle
+    // of a COPY or stream cannot run the ROLLBACK below; closing it is cheaper
+    // than draining the rest of the data
+    if (pgconn_session_busy(conn)) {
+        discard_slot(pool, slot);
+        return;
+    }
+
+    // Never hand a connection with leftover state to the next caller, including
+    // a transaction opened by a plain or asynchronous "BEGIN" query
+    PGTransactionStatusType tx_status = PQtransactionStatus(pgconn_get_raw(conn));
+    if (pgconn_in_transaction(conn)) {
+        pgconn_rollback(conn);
+    } else if (tx_status == PQTRANS_INTRANS || tx_status == PQTRANS_INERROR) {
+        pgconn_execute(conn, "ROLLBACK", NULL);
+    }
+    pgconn_clear_error(conn);
+
+    if (pgconn_status(conn) != CONNECTION_OK || lifetime_expired(pool, conn, time(NULL))) {
+        discard_slot(pool, slot);
+        return;
+    }
+
+    // Keep the connection for this thread's next acquire unless it is already
+    // holding another one (the preference follows the most recent acquire)
+    if (pool->config.thread_affinity && pthread_getspecific(pool->affinity_key) == slot) {
+        __atomic_store_n(&slot->parked, true, __ATOMIC_SEQ_CST);
+    } else {
+        stack_push(pool, &pool->idle, slot);
+    }
+    notify_waiter(pool);
+}
+
+// === Pool State ===
+
+void pgconn_pool_stats(pgconn_pool_t* pool, pgconn_pool_stats_t* stats) {
+    if (!stats) return;
+
+    memset(stats, 0, sizeof(*stats));
+    if (!pool) return;
+
+    if (pool->nodes) {
+        // Sum the sub-pools; the breaker shown is the primary's
+        pool_node_t* primary = least_outstanding(pool, NODE_PRIMARY);
+        for (size_t i = 0; i < pool->n_nodes; i++) {
+            pgconn_pool_stats_t node_stats;
+            pgconn_pool_stats(pool->nodes[i].pool, &node_stats);
+            stats->total += node_stats.total;
+            stats->idle += node_stats.idle;
+            stats->parked += node_stats.parked;
+            stats->in_use += node_stats.in_use;
+            stats->waiting += node_stats.waiting;
+            if (&pool->nodes[i] == primary) {
+                stats->breaker = node_stats.breaker;
+            }
+        }
+        stats->warmup_ms = pool->warmup_ms;
+        return;
+    }
+
+    // Walk the idle stack without popping. Links are always valid slot indexes,
+    // so a concurrent push/pop only makes the count approximate.
+    uint32_t link = (uint32_t)__atomic_load_n(&pool->idle.head, __ATOMIC_ACQUIRE);
+    while (link != PGPOOL_NIL && stats->idle < pool->config.max_size) {
+        stats->idle++;
+        link = __atomic_load_n(&pool->slots[link - 1].next, __ATOMIC_RELAXED);
+    }
+
+    for (size_t i = 0; pool->config.thread_affinity && i < pool->config.max_size; i++) {
+        if (__atomic_load_n(&pool->slots[i].parked, __ATOMIC_RELAXED)) {
+            stats->parked++;
+        }
+    }
+    stats->idle += stats->parked;
+
+    stats->total     = __atomic_load_n(&pool->total, __ATOMIC_RELAXED);
+    stats->in_use    = stats->total > stats->idle ? stats->total - stats->idle : 0;
+    stats->waiting   = __atomic_load_n(&pool->waiting, __ATOMIC_RELAXED);
+    stats->warmup_ms = pool->warmup_ms;
+    stats->breaker   = (pgconn_breaker_state_t)__atomic_load_n(&pool->breaker_state, __ATOMIC_ACQUIRE);
+}
+
+const char* pgconn_pool_error_message(pgconn_pool_t* pool) {
+    (void)pool;
+
+    if (tls_pool_error[0]) {
+        return tls_pool_error;
+    }
+
+    return "No error information available";
+}
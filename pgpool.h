@@ -0,0 +1,235 @@
+/**
+ * @file pgpool.h
+ * @brief A bounded pool of pgconn_t connections shared between threads.
+ *
+ * The pool hands out exclusive ownership of a connection for the duration of a
+ * checkout, so the default (non-locking) pgconn_* functions can be used on it.
+ * This avoids serializing every thread on a single thread_safe connection.
+ *
+ * Design principles:
+ * - Connections are created lazily up to max_size; min_size are opened eagerly
+ *   and concurrently, with registered statements prepared before first use.
+ * - Idle connections live on a lock-free stack and are reused in LIFO order to
+ *   keep hot sockets busy. Checkout and checkin are a single CAS each.
+ * - Optionally, each thread keeps its own connection between checkouts and
+ *   only shares it when the pool runs out.
+ * - Only when the pool is exhausted do callers fall back to a mutex and
+ *   condition variable, with an optional timeout.
+ * - Connections returned in a broken state are destroyed instead of reused.
+ * - While the database is unreachable, a circuit breaker stops every caller
+ *   from hammering it with connection attempts.
+ * - A pool can span a primary and its replicas, routing read-only checkouts
+ *   to the least busy replica.
+ */
+
+#ifndef PGPOOL_H
+#define PGPOOL_H
+
+#include <stddef.h>
+
+#include "pgconn.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Forward declarations
+typedef struct pgconn_pool pgconn_pool_t;
+
+/**
+ * Statement prepared on every pool connection as soon as it is opened, so
+ * callers can run pgconn_execute_prepared() on any connection they acquire.
+ */
+typedef struct {
+    const char* name;   // Statement name
+    const char* query;  // SQL with $1, $2, ... placeholders
+    int n_params;       // Number of parameters (types are inferred by the server)
+} pgconn_pool_statement_t;
+
+/**
+ * Configuration for creating a connection pool.
+ */
+typedef struct {
+    /** Configuration used for every connection in the pool (conninfo is required). */
+    pgconn_config_t conn_config;
+
+    /** Number of connections opened by pgconn_pool_create() and kept open. */
+    size_t min_size;
+
+    /** Maximum number of open connections (0 = same as min_size, minimum 1). */
+    size_t max_size;
+
+    /** Run pgconn_validate_fast() on idle connections before handing them out. */
+    bool validate_on_acquire;
+
+    /**
+     * Idle seconds after which validation also sends SELECT 1 (0 = always,
+     * -1 = never). Below it, only the connection status and the socket are
+     * checked, which costs no round trip.
+     */
+    int validate_idle_s;
+
+    /**
+     * Interval of a background thread that validates idle connections and
+     * closes broken ones (0 = no validation). The same thread enforces
+     * idle_timeout_s and max_lifetime_s, once a second if this is 0. It checks
+     * idle connections one at a time; each one it keeps rejoins the shared
+     * stack when the round ends.
+     */
+    int validate_interval_ms;
+
+    /**
+     * Close connections that have been idle (see pgconn_last_activity()) for
+     * this many seconds, down to min_size (0 = never).
+     */
+    int idle_timeout_s;
+
+    /**
+     * Replace connections this many seconds after they were opened, so the
+     * memory a backend accumulates stays bounded (0 = never). Each connection
+     * gets a random limit up to 10% shorter, so connections opened together
+     * are not all replaced at once. Expired connections are closed when
+     * released or while idle, and the pool reopens them up to min_size.
+     */
+    int max_lifetime_s;
+
+    /**
+     * Keep each thread on the connection it used last. A released connection
+     * is parked for the releasing thread instead of returning to the shared
+     * stack, so the next acquire on that thread gets the same socket and
+     * session state back. Other threads take parked connections only when no
+     * idle connection is left and the pool is at max_size. When a thread
+     * exits, its parked connection returns to the shared stack.
+     */
+    bool thread_affinity;
+
+    /** Statements to prepare on every new connection (copied; may be NULL). */
+    const pgconn_pool_statement_t* statements;
+
+    /** Number of entries in statements. */
+    size_t n_statements;
+
+    /**
+     * conninfo strings of every node of a primary/replica cluster (copied; may
+     * be NULL). When set, conn_config.conninfo is ignored and the pool keeps a
+     * sub-pool of min_size..max_size connections per node. Each node's role
+     * is detected from the server (in_hot_standby, or pg_is_in_recovery() on
+     * servers before PostgreSQL 14) and followed across failovers.
+     */
+    const char* const* node_conninfos;
+
+    /** Number of entries in node_conninfos (0 = single node from conn_config). */
+    size_t n_nodes;
+} pgconn_pool_config_t;
+
+/**
+ * State of the pool's circuit breaker for opening new connections.
+ *
+ * The breaker is enabled by conn_config.auto_reconnect. After
+ * conn_config.max_reconnect_attempts consecutive failures to open a connection
+ * (0 = 5), it opens and acquires that need a new connection fail fast. It stays
+ * open for conn_config.reconnect_base_delay_ms, doubling after every failed
+ * probe up to reconnect_max_delay_ms, then lets a single probe through
+ * (half-open). A successful probe closes it again.
+ */
+typedef enum {
+    PGCONN_BREAKER_CLOSED = 0,  // Healthy: new connections are opened on demand
+    PGCONN_BREAKER_OPEN,        // Database considered down: opening fails fast
+    PGCONN_BREAKER_HALF_OPEN,   // One probe connection is being attempted
+} pgconn_breaker_state_t;
+
+/**
+ * Pool counters. Values are gathered without locking, so they are approximate
+ * while other threads acquire and release connections.
+ */
+typedef struct {
+    size_t total;      // Open connections (idle + in use)
+    size_t idle;       // Connections waiting in the pool (including parked ones)
+    size_t parked;     // Idle connections reserved for their last thread (thread_affinity)
+    size_t in_use;     // Connections checked out by callers
+    size_t waiting;    // Threads blocked in pgconn_pool_acquire()
+    double warmup_ms;  // Time pgconn_pool_create() spent opening and preparing min_size connections
+    pgconn_breaker_state_t breaker;  // Circuit breaker state
+} pgconn_pool_stats_t;
+
+/**
+ * Creates a connection pool and warms it up.
+ *
+ * The min_size connections are opened concurrently from the calling thread
+ * (connection_init runs on each), then the registered statements are prepared
+ * on all of them in parallel. The function returns only once every connection
+ * is ready, so a service can report readiness as soon as it returns.
+ *
+ * With node_conninfos set, every node is warmed up in turn. Nodes that cannot
+ * be reached are retried later when no node of the needed role is known.
+ *
+ * @param config Pool configuration. Must not be NULL.
+ * @return New pool on success, NULL if any warm-up connection fails (for a
+ *         multi-node pool: if no node can be reached).
+ * @note Caller must free with pgconn_pool_destroy().
+ */
+pgconn_pool_t* pgconn_pool_create(const pgconn_pool_config_t* config);
+
+/**
+ * Destroys the pool and closes all idle connections.
+ * @param pool Pool to destroy. Safe to call with NULL.
+ * @note All checked out connections must be released before calling this.
+ */
+void pgconn_pool_destroy(pgconn_pool_t* pool);
+
+/**
+ * Checks out a connection for exclusive use by the calling thread.
+ * @param pool Pool to acquire from.
+ * @param timeout_ms Maximum time to wait for a free connection (-1 = infinite, 0 = no wait).
+ * @return Connection on success, NULL on timeout or connection failure.
+ * @note Thread-safe. Return the connection with pgconn_pool_release().
+ */
+pgconn_t* pgconn_pool_acquire(pgconn_pool_t* pool, int timeout_ms);
+
+/**
+ * Checks out a connection for read-only work.
+ *
+ * In a multi-node pool, the connection comes from the replica with the fewest
+ * connections checked out, or from the primary if no replica is available.
+ * An unreachable node is probed again only after a backoff (doubling from
+ * reconnect_base_delay_ms up to reconnect_max_delay_ms); until then reads go
+ * straight to the primary. pgconn_pool_acquire() always returns a primary
+ * connection there. In a single-node pool this is the same as
+ * pgconn_pool_acquire().
+ *
+ * @param pool Pool to acquire from.
+ * @param timeout_ms Maximum time to wait for a free connection (-1 = infinite, 0 = no wait).
+ * @return Connection on success, NULL on timeout or connection failure.
+ * @note Thread-safe. Return the connection with pgconn_pool_release().
+ */
+pgconn_t* pgconn_pool_acquire_ro(pgconn_pool_t* pool, int timeout_ms);
+
+/**
+ * Returns a connection to the pool.
+ * @param pool Pool the connection was acquired from.
+ * @param conn Connection to return. Safe to call with NULL.
+ * @note Thread-safe. Open transactions are rolled back; broken connections are closed.
+ */
+void pgconn_pool_release(pgconn_pool_t* pool, pgconn_t* conn);
+
+/**
+ * Gets an approximate snapshot of the pool counters.
+ * @param pool Pool to inspect.
+ * @param stats Output structure. Must not be NULL.
+ * @note Thread-safe.
+ */
+void pgconn_pool_stats(pgconn_pool_t* pool, pgconn_pool_stats_t* stats);
+
+/**
+ * Gets the last pool error raised on the calling thread.
+ * @param pool Pool to query.
+ * @return Error message string, never NULL.
+ * @note Thread-safe. Errors are tracked per thread, not per pool.
+ */
+const char* pgconn_pool_error_message(pgconn_pool_t* pool);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // PGPOOL_H
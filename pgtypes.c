@@ -4,15 +4,539 @@
 
 #include "pgtypes.h"
 
+#include <errno.h>
+#include <float.h>
+#include <stdint.h>
+#include <strings.h>
+
+// === Binary Decoding Helpers ===
+
+/** Reads a big-endian 16-bit value. */
+static inline uint16_t read_be16(const char* p) {
+    uint16_t v;
+    memcpy(&v, p, sizeof(v));
+#if __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+    v = __builtin_bswap16(v);
+#endif
+    return v;
+}
+
+/** Reads a big-endian 32-bit value. */
+static inline uint32_t read_be32(const char* p) {
+    uint32_t v;
+    memcpy(&v, p, sizeof(v));
+#if __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+    v = __builtin_bswap32(v);
+#endif
+    return v;
+}
+
+/** Reads a big-endian 64-bit value. */
+static inline uint64_t read_be64(const char* p) {
+    uint64_t v;
+    memcpy(&v, p, sizeof(v));
+#if __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+    v = __builtin_bswap64(v);
+#endif
+    return v;
+}
+
+/** Returns true if the column is delivered in binary format. */
+static inline bool is_binary(const PGresult* res, int col) {
+    return PQfformat(res, col) == 1;
+}
+
+/** Decodes a binary int2/int4/int8/oid value. Returns false for other types or bad lengths. */
+static bool binary_integer(const PGresult* res, int row, int col, long long* out) {
+    const char* val = PQgetvalue(res, row, col);
+    int len         = PQgetlength(res, row, col);
+
+    switch (PQftype(res, col)) {
+        case PG_OID_INT2:
+            if (len != 2) return false;
+            *out = (int16_t)read_be16(val);
+            return true;
+        case PG_OID_INT4:
+            if (len != 4) return false;
+            *out = (int32_t)read_be32(val);
+            return true;
+        case PG_OID_OID:
+            if (len != 4) return false;
+            *out = read_be32(val);
+            return true;
+        case PG_OID_INT8:
+            if (len != 8) return false;
+            *out = (int64_t)read_be64(val);
+            return true;
+        default:
+            return false;
+    }
+}
+
+/** Decodes a binary float4/float8 (or integer) value. Returns false for other types or bad lengths. */
+static bool binary_double(const PGresult* res, int row, int col, double* out) {
+    const char* val = PQgetvalue(res, row, col);
+    int len         = PQgetlength(res, row, col);
+
+    switch (PQftype(res, col)) {
+        case PG_OID_FLOAT4: {
+            if (len != 4) return false;
+            uint32_t bits = read_be32(val);
+            float f;
+            memcpy(&f, &bits, sizeof(f));
+            *out = f;
+            return true;
+        }
+        case PG_OID_FLOAT8: {
+            if (len != 8) return false;
+            uint64_t bits = read_be64(val);
+            memcpy(out, &bits, sizeof(*out));
+            return true;
+        }
+        default: {
+            long long i;
+            if (!binary_integer(res, row, col, &i)) return false;
+            *out = (double)i;
+            return true;
+        }
+    }
+}
+
+// === Text Parsing ===
+
+/*
+ * PostgreSQL prints numbers in a fixed, locale-independent format, so the text
+ * getters try these parsers before falling back to strtol()/strtod(). Each
+ * fast parser either produces the exact libc result or declines, in which
+ * case the libc path runs unchanged.
+ */
+
+/** Reads 8 bytes in little-endian order, so the first character is the low byte. */
+static inline uint64_t read_le64(const char* p) {
+    uint64_t v;
+    memcpy(&v, p, sizeof(v));
+#if __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+    v = __builtin_bswap64(v);
+#endif
+    return v;
+}
+
+/** Returns true if all 8 characters packed in v are ASCII digits. */
+static inline bool swar_all_digits(uint64_t v) {
+    return ((v & 0xF0F0F0F0F0F0F0F0ULL) | (((v + 0x0606060606060606ULL) & 0xF0F0F0F0F0F0F0F0ULL) >> 4)) ==
+           0x3333333333333333ULL;
+}
+
+/** Converts 8 ASCII digits packed in v to their value with three multiplications. */
+static inline uint32_t swar_eight_digits(uint64_t v) {
+    v -= 0x3030303030303030ULL;
+    v = (v * 10) + (v >> 8);  // Pairs of digits
+    v = (((v & 0x000000FF000000FFULL) * (100 + (1000000ULL << 32))) +
+         (((v >> 16) & 0x000000FF000000FFULL) * (1 + (10000ULL << 32)))) >>
+        32;
+    return (uint32_t)v;
+}
+
+/**
+ * Accumulates the digit run at p into *value, 8 digits at a time while at
+ * least 8 characters remain. Adds the number of digits to *n (the value wraps
+ * past 19 digits; callers check *n). Returns the first non-digit.
+ */
+static const char* scan_digits(const char* p, const char* end, uint64_t* value, int* n) {
+    uint64_t v = *value;
+    const char* start = p;
+
+    while (end - p >= 8) {
+        uint64_t chunk = read_le64(p);
+        if (!swar_all_digits(chunk)) break;
+        v = v * 100000000 + swar_eight_digits(chunk);
+        p += 8;
+    }
+    while (p < end && (unsigned char)(*p - '0') < 10) {
+        v = v * 10 + (uint64_t)(*p - '0');
+        p++;
+    }
+
+    *value = v;
+    *n += (int)(p - start);
+    return p;
+}
+
+/** Parses -?[0-9]+ spanning exactly len bytes. Returns false for anything else or on overflow. */
+static bool parse_integer(const char* s, int len, long long* out) {
+    const char* p   = s;
+    const char* end = s + len;
+
+    bool neg = p < end && *p == '-';
+    if (neg) p++;
+
+    while (p < end - 1 && *p == '0') p++;  // Leading zeros do not count towards 19 digits
+
+    uint64_t v = 0;
+    int n      = 0;
+    if (scan_digits(p, end, &v, &n) != end || n == 0 || n > 19) {
+        return false;
+    }
+
+    if (neg) {
+        if (v > (uint64_t)LLONG_MAX + 1) return false;
+        *out = v == (uint64_t)LLONG_MAX + 1 ? LLONG_MIN : -(long long)v;
+    } else {
+        if (v > (uint64_t)LLONG_MAX) return false;
+        *out = (long long)v;
+    }
+    return true;
+}
+
+__extension__ typedef unsigned __int128 uint128_t;
+
+// Decimal exponents covered by the Eisel-Lemire table; others go to strtod()
+#define POW10_MIN_EXP (-64)
+#define POW10_MAX_EXP 64
+
+/**
+ * 128-bit mantissas of 10^e for e in [POW10_MIN_EXP, POW10_MAX_EXP], rounded
+ * down and normalized so the top bit is set, as {low, high} 64-bit halves.
+ */
+static const uint64_t POW10_MANTISSA[POW10_MAX_EXP - POW10_MIN_EXP + 1][2] = {
+    {0x3F2398D747B36224ULL, 0xA87FEA27A539E9A5ULL},  // 1e-64
+    {0x8EEC7F0D19A03AADULL, 0xD29FE4B18E88640EULL},  // 1e-63
+    {0x1953CF68300424ACULL, 0x83A3EEEEF9153E89ULL},  // 1e-62
+    {0x5FA8C3423C052DD7ULL, 0xA48CEAAAB75A8E2BULL},  // 1e-61
+    {0x3792F412CB06794DULL, 0xCDB02555653131B6ULL},  // 1e-60
+    {0xE2BBD88BBEE40BD0ULL, 0x808E17555F3EBF11ULL},  // 1e-59
+    {0x5B6ACEAEAE9D0EC4ULL, 0xA0B19D2AB70E6ED6ULL},  // 1e-58
+    {0xF245825A5A445275ULL, 0xC8DE047564D20A8BULL},  // 1e-57
+    {0xEED6E2F0F0D56712ULL, 0xFB158592BE068D2EULL},  // 1e-56
+    {0x55464DD69685606BULL, 0x9CED737BB6C4183DULL},  // 1e-55
+    {0xAA97E14C3C26B886ULL, 0xC428D05AA4751E4CULL},  // 1e-54
+    {0xD53DD99F4B3066A8ULL, 0xF53304714D9265DFULL},  // 1e-53
+    {0xE546A8038EFE4029ULL, 0x993FE2C6D07B7FABULL},  // 1e-52
+    {0xDE98520472BDD033ULL, 0xBF8FDB78849A5F96ULL},  // 1e-51
+    {0x963E66858F6D4440ULL, 0xEF73D256A5C0F77CULL},  // 1e-50
+    {0xDDE7001379A44AA8ULL, 0x95A8637627989AADULL},  // 1e-49
+    {0x5560C018580D5D52ULL, 0xBB127C53B17EC159ULL},  // 1e-48
+    {0xAAB8F01E6E10B4A6ULL, 0xE9D71B689DDE71AFULL},  // 1e-47
+    {0xCAB3961304CA70E8ULL, 0x9226712162AB070DULL},  // 1e-46
+    {0x3D607B97C5FD0D22ULL, 0xB6B00D69BB55C8D1ULL},  // 1e-45
+    {0x8CB89A7DB77C506AULL, 0xE45C10C42A2B3B05ULL},  // 1e-44
+    {0x77F3608E92ADB242ULL, 0x8EB98A7A9A5B04E3ULL},  // 1e-43
+    {0x55F038B237591ED3ULL, 0xB267ED1940F1C61CULL},  // 1e-42
+    {0x6B6C46DEC52F6688ULL, 0xDF01E85F912E37A3ULL},  // 1e-41
+    {0x2323AC4B3B3DA015ULL, 0x8B61313BBABCE2C6ULL},  // 1e-40
+    {0xABEC975E0A0D081AULL, 0xAE397D8AA96C1B77ULL},  // 1e-39
+    {0x96E7BD358C904A21ULL, 0xD9C7DCED53C72255ULL},  // 1e-38
+    {0x7E50D64177DA2E54ULL, 0x881CEA14545C7575ULL},  // 1e-37
+    {0xDDE50BD1D5D0B9E9ULL, 0xAA242499697392D2ULL},  // 1e-36
+    {0x955E4EC64B44E864ULL, 0xD4AD2DBFC3D07787ULL},  // 1e-35
+    {0xBD5AF13BEF0B113EULL, 0x84EC3C97DA624AB4ULL},  // 1e-34
+    {0xECB1AD8AEACDD58EULL, 0xA6274BBDD0FADD61ULL},  // 1e-33
+    {0x67DE18EDA5814AF2ULL, 0xCFB11EAD453994BAULL},  // 1e-32
+    {0x80EACF948770CED7ULL, 0x81CEB32C4B43FCF4ULL},  // 1e-31
+    {0xA1258379A94D028DULL, 0xA2425FF75E14FC31ULL},  // 1e-30
+    {0x096EE45813A04330ULL, 0xCAD2F7F5359A3B3EULL},  // 1e-29
+    {0x8BCA9D6E188853FCULL, 0xFD87B5F28300CA0DULL},  // 1e-28
+    {0x775EA264CF55347DULL, 0x9E74D1B791E07E48ULL},  // 1e-27
+    {0x95364AFE032A819DULL, 0xC612062576589DDAULL},  // 1e-26
+    {0x3A83DDBD83F52204ULL, 0xF79687AED3EEC551ULL},  // 1e-25
+    {0xC4926A9672793542ULL, 0x9ABE14CD44753B52ULL},  // 1e-24
+    {0x75B7053C0F178293ULL, 0xC16D9A0095928A27ULL},  // 1e-23
+    {0x5324C68B12DD6338ULL, 0xF1C90080BAF72CB1ULL},  // 1e-22
+    {0xD3F6FC16EBCA5E03ULL, 0x971DA05074DA7BEEULL},  // 1e-21
+    {0x88F4BB1CA6BCF584ULL, 0xBCE5086492111AEAULL},  // 1e-20
+    {0x2B31E9E3D06C32E5ULL, 0xEC1E4A7DB69561A5ULL},  // 1e-19
+    {0x3AFF322E62439FCFULL, 0x9392EE8E921D5D07ULL},  // 1e-18
+    {0x09BEFEB9FAD487C2ULL, 0xB877AA3236A4B449ULL},  // 1e-17
+    {0x4C2EBE687989A9B3ULL, 0xE69594BEC44DE15BULL},  // 1e-16
+    {0x0F9D37014BF60A10ULL, 0x901D7CF73AB0ACD9ULL},  // 1e-15
+    {0x538484C19EF38C94ULL, 0xB424DC35095CD80FULL},  // 1e-14
+    {0x2865A5F206B06FB9ULL, 0xE12E13424BB40E13ULL},  // 1e-13
+    {0xF93F87B7442E45D3ULL, 0x8CBCCC096F5088CBULL},  // 1e-12
+    {0xF78F69A51539D748ULL, 0xAFEBFF0BCB24AAFEULL},  // 1e-11
+    {0xB573440E5A884D1BULL, 0xDBE6FECEBDEDD5BEULL},  // 1e-10
+    {0x31680A88F8953030ULL, 0x89705F4136B4A597ULL},  // 1e-9
+    {0xFDC20D2B36BA7C3DULL, 0xABCC77118461CEFCULL},  // 1e-8
+    {0x3D32907604691B4CULL, 0xD6BF94D5E57A42BCULL},  // 1e-7
+    {0xA63F9A49C2C1B10FULL, 0x8637BD05AF6C69B5ULL},  // 1e-6
+    {0x0FCF80DC33721D53ULL, 0xA7C5AC471B478423ULL},  // 1e-5
+    {0xD3C36113404EA4A8ULL, 0xD1B71758E219652BULL},  // 1e-4
+    {0x645A1CAC083126E9ULL, 0x83126E978D4FDF3BULL},  // 1e-3
+    {0x3D70A3D70A3D70A3ULL, 0xA3D70A3D70A3D70AULL},  // 1e-2
+    {0xCCCCCCCCCCCCCCCCULL, 0xCCCCCCCCCCCCCCCCULL},  // 1e-1
+    {0x0000000000000000ULL, 0x8000000000000000ULL},  // 1e0
+    {0x0000000000000000ULL, 0xA000000000000000ULL},  // 1e1
+    {0x0000000000000000ULL, 0xC800000000000000ULL},  // 1e2
+    {0x0000000000000000ULL, 0xFA00000000000000ULL},  // 1e3
+    {0x0000000000000000ULL, 0x9C40000000000000ULL},  // 1e4
+    {0x0000000000000000ULL, 0xC350000000000000ULL},  // 1e5
+    {0x0000000000000000ULL, 0xF424000000000000ULL},  // 1e6
+    {0x0000000000000000ULL, 0x9896800000000000ULL},  // 1e7
+    {0x0000000000000000ULL, 0xBEBC200000000000ULL},  // 1e8
+    {0x0000000000000000ULL, 0xEE6B280000000000ULL},  // 1e9
+    {0x0000000000000000ULL, 0x9502F90000000000ULL},  // 1e10
+    {0x0000000000000000ULL, 0xBA43B74000000000ULL},  // 1e11
+    {0x0000000000000000ULL, 0xE8D4A51000000000ULL},  // 1e12
+    {0x0000000000000000ULL, 0x9184E72A00000000ULL},  // 1e13
+    {0x0000000000000000ULL, 0xB5E620F480000000ULL},  // 1e14
+    {0x0000000000000000ULL, 0xE35FA931A0000000ULL},  // 1e15
+    {0x0000000000000000ULL, 0x8E1BC9BF04000000ULL},  // 1e16
+    {0x0000000000000000ULL, 0xB1A2BC2EC5000000ULL},  // 1e17
+    {0x0000000000000000ULL, 0xDE0B6B3A76400000ULL},  // 1e18
+    {0x0000000000000000ULL, 0x8AC7230489E80000ULL},  // 1e19
+    {0x0000000000000000ULL, 0xAD78EBC5AC620000ULL},  // 1e20
+    {0x0000000000000000ULL, 0xD8D726B7177A8000ULL},  // 1e21
+    {0x0000000000000000ULL, 0x878678326EAC9000ULL},  // 1e22
+    {0x0000000000000000ULL, 0xA968163F0A57B400ULL},  // 1e23
+    {0x0000000000000000ULL, 0xD3C21BCECCEDA100ULL},  // 1e24
+    {0x0000000000000000ULL, 0x84595161401484A0ULL},  // 1e25
+    {0x0000000000000000ULL, 0xA56FA5B99019A5C8ULL},  // 1e26
+    {0x0000000000000000ULL, 0xCECB8F27F4200F3AULL},  // 1e27
+    {0x4000000000000000ULL, 0x813F3978F8940984ULL},  // 1e28
+    {0x5000000000000000ULL, 0xA18F07D736B90BE5ULL},  // 1e29
+    {0xA400000000000000ULL, 0xC9F2C9CD04674EDEULL},  // 1e30
+    {0x4D00000000000000ULL, 0xFC6F7C4045812296ULL},  // 1e31
+    {0xF020000000000000ULL, 0x9DC5ADA82B70B59DULL},  // 1e32
+    {0x6C28000000000000ULL, 0xC5371912364CE305ULL},  // 1e33
+    {0xC732000000000000ULL, 0xF684DF56C3E01BC6ULL},  // 1e34
+    {0x3C7F400000000000ULL, 0x9A130B963A6C115CULL},  // 1e35
+    {0x4B9F100000000000ULL, 0xC097CE7BC90715B3ULL},  // 1e36
+    {0x1E86D40000000000ULL, 0xF0BDC21ABB48DB20ULL},  // 1e37
+    {0x1314448000000000ULL, 0x96769950B50D88F4ULL},  // 1e38
+    {0x17D955A000000000ULL, 0xBC143FA4E250EB31ULL},  // 1e39
+    {0x5DCFAB0800000000ULL, 0xEB194F8E1AE525FDULL},  // 1e40
+    {0x5AA1CAE500000000ULL, 0x92EFD1B8D0CF37BEULL},  // 1e41
+    {0xF14A3D9E40000000ULL, 0xB7ABC627050305ADULL},  // 1e42
+    {0x6D9CCD05D0000000ULL, 0xE596B7B0C643C719ULL},  // 1e43
+    {0xE4820023A2000000ULL, 0x8F7E32CE7BEA5C6FULL},  // 1e44
+    {0xDDA2802C8A800000ULL, 0xB35DBF821AE4F38BULL},  // 1e45
+    {0xD50B2037AD200000ULL, 0xE0352F62A19E306EULL},  // 1e46
+    {0x4526F422CC340000ULL, 0x8C213D9DA502DE45ULL},  // 1e47
+    {0x9670B12B7F410000ULL, 0xAF298D050E4395D6ULL},  // 1e48
+    {0x3C0CDD765F114000ULL, 0xDAF3F04651D47B4CULL},  // 1e49
+    {0xA5880A69FB6AC800ULL, 0x88D8762BF324CD0FULL},  // 1e50
+    {0x8EEA0D047A457A00ULL, 0xAB0E93B6EFEE0053ULL},  // 1e51
+    {0x72A4904598D6D880ULL, 0xD5D238A4ABE98068ULL},  // 1e52
+    {0x47A6DA2B7F864750ULL, 0x85A36366EB71F041ULL},  // 1e53
+    {0x999090B65F67D924ULL, 0xA70C3C40A64E6C51ULL},  // 1e54
+    {0xFFF4B4E3F741CF6DULL, 0xD0CF4B50CFE20765ULL},  // 1e55
+    {0xBFF8F10E7A8921A4ULL, 0x82818F1281ED449FULL},  // 1e56
+    {0xAFF72D52192B6A0DULL, 0xA321F2D7226895C7ULL},  // 1e57
+    {0x9BF4F8A69F764490ULL, 0xCBEA6F8CEB02BB39ULL},  // 1e58
+    {0x02F236D04753D5B4ULL, 0xFEE50B7025C36A08ULL},  // 1e59
+    {0x01D762422C946590ULL, 0x9F4F2726179A2245ULL},  // 1e60
+    {0x424D3AD2B7B97EF5ULL, 0xC722F0EF9D80AAD6ULL},  // 1e61
+    {0xD2E0898765A7DEB2ULL, 0xF8EBAD2B84E0D58BULL},  // 1e62
+    {0x63CC55F49F88EB2FULL, 0x9B934C3B330C8577ULL},  // 1e63
+    {0x3CBF6B71C76B25FBULL, 0xC2781F49FFCFA6D5ULL},  // 1e64
+
+};
+
+/**
+ * Converts w * 10^q to the nearest double with the Eisel-Lemire algorithm.
+ * w must be non-zero. Returns false when the table does not cover q, the
+ * result is subnormal or infinite, or the product is too close to a rounding
+ * boundary to decide; strtod() settles those.
+ */
+static bool eisel_lemire(uint64_t w, int q, double* out) {
+    if (q < POW10_MIN_EXP || q > POW10_MAX_EXP) return false;
+
+    const uint64_t* pow10 = POW10_MANTISSA[q - POW10_MIN_EXP];
+
+    int lz = __builtin_clzll(w);
+    w <<= lz;
+
+    // floor(log2(10^q)) + 64 + bias, minus the normalization shift
+    uint64_t exp2 = (uint64_t)(((217706 * q) >> 16) + 64 + 1023) - (uint64_t)lz;
+
+    uint128_t product = (uint128_t)w * pow10[1];
+    uint64_t hi       = (uint64_t)(product >> 64);
+    uint64_t lo       = (uint64_t)product;
+
+    // The low bits may carry into the result: widen with the second table word
+    if ((hi & 0x1FF) == 0x1FF && lo + w < w) {
+        uint128_t wide  = (uint128_t)w * pow10[0];
+        uint64_t wide_hi = (uint64_t)(wide >> 64);
+        uint64_t wide_lo = (uint64_t)wide;
+
+        uint64_t merged_lo = lo + wide_hi;
+        if (merged_lo < lo) hi++;
+        if ((hi & 0x1FF) == 0x1FF && merged_lo + 1 == 0 && wide_lo + w < w) {
+            return false;
+        }
+        lo = merged_lo;
+    }
+
+    uint64_t msb      = hi >> 63;
+    uint64_t mantissa = hi >> (msb + 9);
+    exp2 -= 1 ^ msb;
+
+    // Exactly halfway between two doubles
+    if (lo == 0 && (hi & 0x1FF) == 0 && (mantissa & 3) == 1) {
+        return false;
+    }
+
+    // Round from 54 to 53 bits
+    mantissa += mantissa & 1;
+    mantissa >>= 1;
+    if (mantissa >> 53) {
+        mantissa >>= 1;
+        exp2++;
+    }
+
+    if (exp2 - 1 >= 0x7FF - 1) return false;  // Subnormal or infinite
+
+    uint64_t bits = exp2 << 52 | (mantissa & 0x000FFFFFFFFFFFFFULL);
+    memcpy(out, &bits, sizeof(*out));
+    return true;
+}
+
+/** Exact powers of ten for the double fast path. */
+static const double EXACT_POW10[] = {1e0,  1e1,  1e2,  1e3,  1e4,  1e5,  1e6,  1e7,  1e8,  1e9,  1e10, 1e11,
+                                     1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22};
+
+/**
+ * Splits a decimal -?digits[.digits][e[+-]digits] spanning exactly len bytes
+ * into its sign, up to 19 significant digits and a decimal exponent.
+ */
+static bool parse_decimal(const char* s, int len, bool* neg, uint64_t* w, int* q) {
+    const char* p   = s;
+    const char* end = s + len;
+
+    *neg = p < end && *p == '-';
+    if (*neg) p++;
+
+    const char* digits = p;
+    while (p < end && *p == '0') p++;
+
+    *w    = 0;
+    int n = 0;
+    p     = scan_digits(p, end, w, &n);
+
+    long exp10 = 0;
+    if (p < end && *p == '.') {
+        const char* frac = ++p;
+        if (n == 0) {
+            while (p < end && *p == '0') p++;  // 0.000123: zeros are not significant
+        }
+        p = scan_digits(p, end, w, &n);
+        exp10 -= (long)(p - frac);
+    }
+
+    if (p == digits || (p - digits == 1 && *digits == '.') || n > 19) {
+        return false;
+    }
+
+    if (p < end && (*p == 'e' || *p == 'E')) {
+        p++;
+        bool exp_neg = p < end && *p == '-';
+        if (p < end && (*p == '-' || *p == '+')) p++;
+
+        const char* exp_digits = p;
+        long e                 = 0;
+        for (; p < end && (unsigned char)(*p - '0') < 10; p++) {
+            if (e < 100000) e = e * 10 + (*p - '0');
+        }
+        if (p == exp_digits) return false;
+        exp10 += exp_neg ? -e : e;
+    }
+
+    if (p != end || exp10 < INT_MIN / 2 || exp10 > INT_MAX / 2) {
+        return false;
+    }
+
+    *q = (int)exp10;
+    return true;
+}
+
+/** Parses a PostgreSQL float8 text value exactly. Returns false to defer to strtod(). */
+static bool parse_double(const char* s, int len, double* out) {
+    bool neg;
+    uint64_t w;
+    int q;
+    if (!parse_decimal(s, len, &neg, &w, &q)) return false;
+
+    double d;
+    if (w == 0) {
+        d = 0.0;
+    }
+#if FLT_EVAL_METHOD == 0
+    // Both operands are exact doubles, so one IEEE operation rounds correctly
+    else if (w <= (1ULL << 53) && q >= -22 && q <= 22) {
+        d = q < 0 ? (double)w / EXACT_POW10[-q] : (double)w * EXACT_POW10[q];
+    }
+#endif
+    else if (!eisel_lemire(w, q, &d)) {
+        return false;
+    }
+
+    *out = neg ? -d : d;
+    return true;
+}
+
+/** Parses a float4 text value exactly when the fast path applies. Returns false to defer to strtof(). */
+static bool parse_float(const char* s, int len, float* out) {
+#if FLT_EVAL_METHOD == 0
+    bool neg;
+    uint64_t w;
+    int q;
+    if (!parse_decimal(s, len, &neg, &w, &q) || w > (1ULL << 24) || q < -10 || q > 10) {
+        return false;
+    }
+
+    float f = q < 0 ? (float)w / (float)EXACT_POW10[-q] : (float)w * (float)EXACT_POW10[q];
+    *out    = neg ? -f : f;
+    return true;
+#else
+    (void)s;
+    (void)len;
+    (void)out;
+    return false;
+#endif
+}
+
+/** Decodes a binary integer and checks it lies in [min, max]. Handles NULL and *valid. */
+static long long get_binary_integer(PGresult* res, int row, int col, long long min, long long max, bool* valid) {
+    long long result;
+    if (PQgetisnull(res, row, col) || !binary_integer(res, row, col, &result) || result < min || result > max) {
+        if (valid) *valid = false;
+        return 0;
+    }
+
+    if (valid) *valid = true;
+    return result;
+}
+
+/** Decodes a binary floating-point or integer value. Handles NULL and *valid. */
+static double get_binary_double(PGresult* res, int row, int col, bool* valid) {
+    double result;
+    if (PQgetisnull(res, row, col) || !binary_double(res, row, col, &result)) {
+        if (valid) *valid = false;
+        return 0.0;
+    }
+
+    if (valid) *valid = true;
+    return result;
+}
+
 // Get an integer value from a PGresult at the specified row and column.
 // Sets *valid to true if successful, false if the value is null or invalid.
 int pg_get_int(PGresult* res, int row, int col, bool* valid) {
+    if (is_binary(res, col)) {
+        return (int)get_binary_integer(res, row, col, INT_MIN, INT_MAX, valid);
+    }
+
     const char* val = PQgetvalue(res, row, col);
     if (!val || PQgetisnull(res, row, col)) {
         if (valid) *valid = false;
         return 0;
     }
 
+    long long fast;
+    if (parse_integer(val, PQgetlength(res, row, col), &fast) && fast >= INT_MIN && fast <= INT_MAX) {
+        if (valid) *valid = true;
+        return (int)fast;
+    }
+
     char* endptr;
     long result = strtol(val, &endptr, 10);
     if (*endptr != '\0' || result < INT_MIN || result > INT_MAX) {
@@ -26,12 +550,22 @@ int pg_get_int(PGresult* res, int row, int col, bool* valid) {
 
 // Get a long value from a PGresult at the specified row and column.
 long pg_get_long(PGresult* res, int row, int col, bool* valid) {
+    if (is_binary(res, col)) {
+        return (long)get_binary_integer(res, row, col, LONG_MIN, LONG_MAX, valid);
+    }
+
     const char* val = PQgetvalue(res, row, col);
     if (!val || PQgetisnull(res, row, col)) {
         if (valid) *valid = false;
         return 0L;
     }
 
+    long long fast;
+    if (parse_integer(val, PQgetlength(res, row, col), &fast) && fast >= LONG_MIN && fast <= LONG_MAX) {
+        if (valid) *valid = true;
+        return (long)fast;
+    }
+
     char* endptr;
     long result = strtol(val, &endptr, 10);
     if (*endptr != '\0') {
@@ -45,12 +579,22 @@ long pg_get_long(PGresult* res, int row, int col, bool* valid) {
 
 // Get a long long value from a PGresult at the specified row and column.
 long long pg_get_longlong(PGresult* res, int row, int col, bool* valid) {
+    if (is_binary(res, col)) {
+        return get_binary_integer(res, row, col, LLONG_MIN, LLONG_MAX, valid);
+    }
+
     const char* val = PQgetvalue(res, row, col);
     if (!val || PQgetisnull(res, row, col)) {
         if (valid) *valid = false;
         return 0LL;
     }
 
+    long long fast;
+    if (parse_integer(val, PQgetlength(res, row, col), &fast)) {
+        if (valid) *valid = true;
+        return fast;
+    }
+
     char* endptr;
     long long result = strtoll(val, &endptr, 10);
     if (*endptr != '\0') {
@@ -64,12 +608,22 @@ long long pg_get_longlong(PGresult* res, int row, int col, bool* valid) {
 
 // Get a float value from a PGresult at the specified row and column.
 float pg_get_float(PGresult* res, int row, int col, bool* valid) {
+    if (is_binary(res, col)) {
+        return (float)get_binary_double(res, row, col, valid);
+    }
+
     const char* val = PQgetvalue(res, row, col);
     if (!val || PQgetisnull(res, row, col)) {
         if (valid) *valid = false;
         return 0.0f;
     }
 
+    float fast;
+    if (parse_float(val, PQgetlength(res, row, col), &fast)) {
+        if (valid) *valid = true;
+        return fast;
+    }
+
     char* endptr;
     float result = strtof(val, &endptr);
     if (*endptr != '\0') {
@@ -83,12 +637,22 @@ float pg_get_float(PGresult* res, int row, int col, bool* valid) {
 
 // Get a double value from a PGresult at the specified row and column.
 double pg_get_double(PGresult* res, int row, int col, bool* valid) {
+    if (is_binary(res, col)) {
+        return get_binary_double(res, row, col, valid);
+    }
+
     const char* val = PQgetvalue(res, row, col);
     if (!val || PQgetisnull(res, row, col)) {
         if (valid) *valid = false;
         return 0.0;
     }
 
+    double fast;
+    if (parse_double(val, PQgetlength(res, row, col), &fast)) {
+        if (valid) *valid = true;
+        return fast;
+    }
+
     char* endptr;
     double result = strtod(val, &endptr);
     if (*endptr != '\0') {
@@ -102,6 +666,16 @@ double pg_get_double(PGresult* res, int row, int col, bool* valid) {
 
 // Get a boolean value from a PGresult at the specified row and column.
 bool pg_get_bool(PGresult* res, int row, int col, bool* valid) {
+    if (is_binary(res, col)) {
+        if (PQgetisnull(res, row, col) || PQftype(res, col) != PG_OID_BOOL || PQgetlength(res, row, col) != 1) {
+            if (valid) *valid = false;
+            return false;
+        }
+
+        if (valid) *valid = true;
+        return PQgetvalue(res, row, col)[0] != 0;
+    }
+
     const char* val = PQgetvalue(res, row, col);
     if (!val || PQgetisnull(res, row, col)) {
         if (valid) *valid = false;
@@ -163,6 +737,11 @@ const unsigned char* pg_get_binary(PGresult* res, int row, int col, size_t* leng
 
 // Get a UUID as a string (PostgreSQL UUID type).
 const char* pg_get_uuid(PGresult* res, int row, int col, bool* valid) {
+    if (is_binary(res, col)) {
+        if (valid) *valid = false;
+        return NULL;
+    }
+
     const char* val = pg_get_string(res, row, col, valid);
     if (valid && !*valid) return NULL;
 
@@ -176,8 +755,103 @@ const char* pg_get_uuid(PGresult* res, int row, int col, bool* valid) {
     return val;
 }
 
+// Get a UUID as 16 raw bytes from either format.
+bool pg_get_uuid_bytes(PGresult* res, int row, int col, unsigned char out[16], bool* valid) {
+    if (PQgetisnull(res, row, col)) {
+        if (valid) *valid = false;
+        return false;
+    }
+
+    if (is_binary(res, col)) {
+        bool ok = PQftype(res, col) == PG_OID_UUID && PQgetlength(res, row, col) == 16;
+        if (ok) memcpy(out, PQgetvalue(res, row, col), 16);
+        if (valid) *valid = ok;
+        return ok;
+    }
+
+    const char* val = pg_get_uuid(res, row, col, valid);
+    if (!val) {
+        if (valid) *valid = false;
+        return false;
+    }
+
+    // 32 hex digits, skipping the dashes at fixed positions
+    size_t n = 0;
+    for (const char* p = val; *p && n < 32; p++) {
+        if (*p == '-') continue;
+
+        int digit;
+        if (*p >= '0' && *p <= '9') {
+            digit = *p - '0';
+        } else if (*p >= 'a' && *p <= 'f') {
+            digit = *p - 'a' + 10;
+        } else if (*p >= 'A' && *p <= 'F') {
+            digit = *p - 'A' + 10;
+        } else {
+            if (valid) *valid = false;
+            return false;
+        }
+
+        if (n % 2 == 0) {
+            out[n / 2] = (unsigned char)(digit << 4);
+        } else {
+            out[n / 2] |= (unsigned char)digit;
+        }
+        n++;
+    }
+
+    if (n != 32) {
+        if (valid) *valid = false;
+        return false;
+    }
+
+    if (valid) *valid = true;
+    return true;
+}
+
+// Decode a binary timestamp/timestamptz (microseconds since 2000-01-01).
+static struct timespec binary_timestamp(PGresult* res, int row, int col, bool* valid) {
+    Oid type = PQftype(res, col);
+    if (PQgetisnull(res, row, col) || (type != PG_OID_TIMESTAMP && type != PG_OID_TIMESTAMPTZ) ||
+        PQgetlength(res, row, col) != 8) {
+        if (valid) *valid = false;
+        return (struct timespec){0, 0};
+    }
+
+    int64_t micros = (int64_t)read_be64(PQgetvalue(res, row, col));
+
+    // Floor division so pre-2000 values keep a non-negative tv_nsec
+    int64_t secs = micros / 1000000;
+    int64_t frac = micros % 1000000;
+    if (frac < 0) {
+        secs--;
+        frac += 1000000;
+    }
+
+    struct timespec ts = {(time_t)(secs + PG_EPOCH_UNIX), (long)frac * 1000};
+
+    // timestamp without time zone is wall-clock time; interpret it in local
+    // time like the text path does
+    if (type == PG_OID_TIMESTAMP) {
+        struct tm tm;
+        if (!gmtime_r(&ts.tv_sec, &tm)) {
+            if (valid) *valid = false;
+            return (struct timespec){0, 0};
+        }
+        tm.tm_isdst = -1;
+        ts.tv_sec   = mktime(&tm);
+    }
+
+    if (valid) *valid = true;
+    return ts;
+}
+
 // Get a timestamp as a string.
 struct timespec pg_get_timestamp(PGresult* res, int row, int col, bool* valid) {
+    if (is_binary(res, col)) {
+        return binary_timestamp(res, row, col, valid);
+    }
+
     const char* s = pg_get_string(res, row, col, valid);
     if ((valid && !*valid) || !s) {
         if (valid) *valid = false;
@@ -244,3 +918,688 @@ struct timespec pg_get_timestamp(PGresult* res, int row, int col, bool* valid) {
     if (valid) *valid = true;
     return ts;
 }
+
+// === Row Mapper ===
+
+/** How a bound column is decoded, chosen once from its format and type. */
+typedef enum {
+    SRC_TEXT,       // Text format: parsed per cell
+    SRC_INT2,       // Binary int2
+    SRC_INT4,       // Binary int4
+    SRC_OID,        // Binary oid (unsigned)
+    SRC_INT8,       // Binary int8
+    SRC_FLOAT4,     // Binary float4
+    SRC_FLOAT8,     // Binary float8
+    SRC_BOOL,       // Binary bool
+    SRC_UUID,       // Binary uuid
+    SRC_TIMESTAMP,  // Binary timestamp or timestamptz
+    SRC_RAW,        // Binary value of any type read as bytes
+} field_source_t;
+
+typedef struct {
+    int col;               // Column number in the result
+    field_source_t src;    // Decoder
+    pg_field_type_t type;  // Member type
+    size_t offset;         // Member offset
+    size_t size;           // Member size
+    bool nullable;         // Has a NULL indicator
+    size_t null_offset;    // NULL indicator offset
+} bound_field_t;
+
+struct pg_binding {
+    int n_columns;           // Columns of the bound result, checked on fill
+    size_t n_fields;         // Entries in fields
+    bound_field_t fields[];  // Resolved mapping
+};
+
+/** Maps a binary column type to its decoder. */
+static field_source_t binary_source(Oid type) {
+    switch (type) {
+        case PG_OID_INT2:        return SRC_INT2;
+        case PG_OID_INT4:        return SRC_INT4;
+        case PG_OID_OID:         return SRC_OID;
+        case PG_OID_INT8:        return SRC_INT8;
+        case PG_OID_FLOAT4:      return SRC_FLOAT4;
+        case PG_OID_FLOAT8:      return SRC_FLOAT8;
+        case PG_OID_BOOL:        return SRC_BOOL;
+        case PG_OID_UUID:        return SRC_UUID;
+        case PG_OID_TIMESTAMP:
+        case PG_OID_TIMESTAMPTZ: return SRC_TIMESTAMP;
+        default:                 return SRC_RAW;
+    }
+}
+
+/** Returns true if a member of this type can hold values from this decoder. */
+static bool source_fits(pg_field_type_t type, field_source_t src) {
+    bool integer = src == SRC_INT2 || src == SRC_INT4 || src == SRC_OID || src == SRC_INT8;
+
+    switch (type) {
+        case PG_FIELD_INT32:
+        case PG_FIELD_INT64:     return src == SRC_TEXT || integer;
+        case PG_FIELD_FLOAT:
+        case PG_FIELD_DOUBLE:    return src == SRC_TEXT || integer || src == SRC_FLOAT4 || src == SRC_FLOAT8;
+        case PG_FIELD_BOOL:      return src == SRC_TEXT || src == SRC_BOOL;
+        case PG_FIELD_STRING:
+        case PG_FIELD_STRBUF:    return true;
+        case PG_FIELD_UUID:      return src == SRC_TEXT || src == SRC_UUID;
+        case PG_FIELD_TIMESTAMP: return src == SRC_TEXT || src == SRC_TIMESTAMP;
+        default:                 return false;
+    }
+}
+
+/** Returns true if the member size matches its type. */
+static bool size_fits(pg_field_type_t type, size_t size) {
+    switch (type) {
+        case PG_FIELD_INT32:     return size == sizeof(int32_t);
+        case PG_FIELD_INT64:     return size == sizeof(int64_t);
+        case PG_FIELD_FLOAT:     return size == sizeof(float);
+        case PG_FIELD_DOUBLE:    return size == sizeof(double);
+        case PG_FIELD_BOOL:      return size == sizeof(bool);
+        case PG_FIELD_STRING:    return size == sizeof(const char*);
+        case PG_FIELD_STRBUF:    return size > 0;
+        case PG_FIELD_UUID:      return size == 16;
+        case PG_FIELD_TIMESTAMP: return size == sizeof(struct timespec);
+        default:                 return false;
+    }
+}
+
+pg_binding_t* pg_bind(const PGresult* res, const pg_field_t* fields, size_t n_fields) {
+    if (!res || (!fields && n_fields > 0)) return NULL;
+
+    pg_binding_t* binding = malloc(sizeof(*binding) + n_fields * sizeof(bound_field_t));
+    if (!binding) return NULL;
+
+    binding->n_columns = PQnfields(res);
+    binding->n_fields  = n_fields;
+
+    for (size_t i = 0; i < n_fields; i++) {
+        const pg_field_t* f = &fields[i];
+        bound_field_t* b    = &binding->fields[i];
+
+        b->col = f->column ? PQfnumber(res, f->column) : -1;
+        if (b->col < 0 || !size_fits(f->type, f->size)) {
+            free(binding);
+            return NULL;
+        }
+
+        b->src = PQfformat(res, b->col) == 1 ? binary_source(PQftype(res, b->col)) : SRC_TEXT;
+        if (!source_fits(f->type, b->src)) {
+            free(binding);
+            return NULL;
+        }
+
+        b->type        = f->type;
+        b->offset      = f->offset;
+        b->size        = f->size;
+        b->nullable    = f->nullable;
+        b->null_offset = f->null_offset;
+    }
+
+    return binding;
+}
+
+void pg_binding_free(pg_binding_t* binding) {
+    free(binding);
+}
+
+/** Decodes an integer cell. Text must be a complete base-10 number within 64 bits. */
+static bool field_integer(field_source_t src, const char* val, int len, long long* out) {
+    switch (src) {
+        case SRC_TEXT: {
+            if (parse_integer(val, len, out)) return true;
+
+            char* end;
+            errno = 0;
+            *out  = strtoll(val, &end, 10);
+            return end != val && *end == '\0' && errno != ERANGE;
+        }
+        case SRC_INT2:
+            if (len != 2) return false;
+            *out = (int16_t)read_be16(val);
+            return true;
+        case SRC_INT4:
+            if (len != 4) return false;
+            *out = (int32_t)read_be32(val);
+            return true;
+        case SRC_OID:
+            if (len != 4) return false;
+            *out = read_be32(val);
+            return true;
+        case SRC_INT8:
+            if (len != 8) return false;
+            *out = (int64_t)read_be64(val);
+            return true;
+        default:
+            return false;
+    }
+}
+
+/** Decodes a floating-point (or integer) cell. */
+static bool field_double(field_source_t src, const char* val, int len, double* out) {
+    switch (src) {
+        case SRC_TEXT: {
+            if (parse_double(val, len, out)) return true;
+
+            char* end;
+            *out = strtod(val, &end);
+            return end != val && *end == '\0';
+        }
+        case SRC_FLOAT4: {
+            if (len != 4) return false;
+            uint32_t bits = read_be32(val);
+            float f;
+            memcpy(&f, &bits, sizeof(f));
+            *out = f;
+            return true;
+        }
+        case SRC_FLOAT8: {
+            if (len != 8) return false;
+            uint64_t bits = read_be64(val);
+            memcpy(out, &bits, sizeof(*out));
+            return true;
+        }
+        default: {
+            long long i;
+            if (!field_integer(src, val, len, &i)) return false;
+            *out = (double)i;
+            return true;
+        }
+    }
+}
+
+/** Returns true for the whitespace PostgreSQL trims around a boolean. */
+static inline bool is_bool_space(char c) {
+    return c == ' ' || (c >= '\t' && c <= '\r');
+}
+
+/**
+ * Decodes a text boolean the way PostgreSQL's boolin() does: a case-insensitive,
+ * unambiguous prefix of true/false/yes/no/on/off, or 1/0, with surrounding
+ * whitespace. Anything else is rejected rather than read as false.
+ */
+static bool field_bool_text(const char* val, int len, bool* out) {
+    static const struct {
+        const char* word;
+        size_t min_len;  // Shortest accepted prefix
+        bool value;
+    } words[] = {
+        {"true", 1, true}, {"false", 1, false}, {"yes", 1, true}, {"no", 1, false},
+        {"on", 2, true},   {"off", 2, false},   {"1", 1, true},   {"0", 1, false},
+    };
+
+    while (len > 0 && is_bool_space(*val)) {
+        val++;
+        len--;
+    }
+    while (len > 0 && is_bool_space(val[len - 1])) {
+        len--;
+    }
+
+    size_t n = (size_t)len;
+    for (size_t i = 0; i < sizeof(words) / sizeof(words[0]); i++) {
+        if (n >= words[i].min_len && n <= strlen(words[i].word) && strncasecmp(val, words[i].word, n) == 0) {
+            *out = words[i].value;
+            return true;
+        }
+    }
+    return false;
+}
+
+/** Decodes one non-NULL cell into its member. */
+static bool fill_field(const bound_field_t* f, PGresult* res, int row, char* dst) {
+    const char* val = PQgetvalue(res, row, f->col);
+    int len         = PQgetlength(res, row, f->col);
+
+    switch (f->type) {
+        case PG_FIELD_INT32: {
+            long long i;
+            if (!field_integer(f->src, val, len, &i) || i < INT32_MIN || i > INT32_MAX) return false;
+            int32_t v = (int32_t)i;
+            memcpy(dst, &v, sizeof(v));
+            return true;
+        }
+        case PG_FIELD_INT64: {
+            long long i;
+            if (!field_integer(f->src, val, len, &i)) return false;
+            int64_t v = (int64_t)i;
+            memcpy(dst, &v, sizeof(v));
+            return true;
+        }
+        case PG_FIELD_FLOAT: {
+            double d;
+            if (!field_double(f->src, val, len, &d)) return false;
+            float v = (float)d;
+            memcpy(dst, &v, sizeof(v));
+            return true;
+        }
+        case PG_FIELD_DOUBLE: {
+            double v;
+            if (!field_double(f->src, val, len, &v)) return false;
+            memcpy(dst, &v, sizeof(v));
+            return true;
+        }
+        case PG_FIELD_BOOL: {
+            bool v;
+            if (f->src == SRC_BOOL) {
+                if (len != 1) return false;
+                v = val[0] != 0;
+            } else if (!field_bool_text(val, len, &v)) {
+                return false;
+            }
+            memcpy(dst, &v, sizeof(v));
+            return true;
+        }
+        case PG_FIELD_STRING:
+            memcpy(dst, &val, sizeof(val));
+            return true;
+        case PG_FIELD_STRBUF: {
+            size_t copy_len = (size_t)len >= f->size ? f->size - 1 : (size_t)len;
+            memcpy(dst, val, copy_len);
+            dst[copy_len] = '\0';
+            return true;
+        }
+        case PG_FIELD_UUID:
+            return pg_get_uuid_bytes(res, row, f->col, (unsigned char*)dst, NULL);
+        case PG_FIELD_TIMESTAMP: {
+            bool ok;
+            struct timespec ts = pg_get_timestamp(res, row, f->col, &ok);
+            memcpy(dst, &ts, sizeof(ts));
+            return ok;
+        }
+        default:
+            return false;
+    }
+}
+
+int pg_binding_fill(const pg_binding_t* binding, const PGresult* res, int first_row, int n_rows, void* out,
+                    size_t stride) {
+    if (!binding || !res || !out || first_row < 0 || PQnfields(res) != binding->n_columns) return -1;
+
+    // The pg_get_* getters take a non-const result but do not modify it
+    PGresult* r = (PGresult*)res;
+
+    int available = PQntuples(res) - first_row;
+    if (n_rows > available) n_rows = available;
+    if (n_rows < 0) n_rows = 0;
+
+    for (int i = 0; i < n_rows; i++) {
+        int row   = first_row + i;
+        char* dst = (char*)out + (size_t)i * stride;
+
+        for (size_t j = 0; j < binding->n_fields; j++) {
+            const bound_field_t* f = &binding->fields[j];
+            bool is_null           = PQgetisnull(r, row, f->col);
+
+            if (f->nullable) {
+                memcpy(dst + f->null_offset, &is_null, sizeof(is_null));
+            }
+
+            if (is_null) {
+                memset(dst + f->offset, 0, f->size);
+            } else if (!fill_field(f, r, row, dst + f->offset)) {
+                return -1;
+            }
+        }
+    }
+
+    return n_rows;
+}
+
+// === Column Extraction ===
+
+/**
+ * Resolves the decoder of a column for the given member type and clamps the
+ * row range. Returns the number of rows to decode, or -1 if the column does
+ * not fit. Clears the validity bitmap.
+ */
+static int column_begin(const PGresult* res, int col, int first_row, int n_rows, pg_field_type_t type,
+                        field_source_t* src, uint8_t* validity) {
+    if (!res || col < 0 || col >= PQnfields(res) || first_row < 0) return -1;
+
+    *src = PQfformat(res, col) == 1 ? binary_source(PQftype(res, col)) : SRC_TEXT;
+    if (!source_fits(type, *src)) return -1;
+
+    int available = PQntuples(res) - first_row;
+    if (n_rows > available) n_rows = available;
+    if (n_rows < 0) n_rows = 0;
+
+    if (validity) memset(validity, 0, ((size_t)n_rows + 7) / 8);
+    return n_rows;
+}
+
+/** Marks row i of the range as not NULL. */
+static inline void validity_set(uint8_t* validity, int i) {
+    if (validity) validity[i >> 3] |= (uint8_t)(1u << (i & 7));
+}
+
+int pg_get_column_int32(const PGresult* res, int col, int first_row, int n_rows, int32_t* out, uint8_t* validity) {
+    field_source_t src;
+    n_rows = column_begin(res, col, first_row, n_rows, PG_FIELD_INT32, &src, validity);
+    if (n_rows < 0 || (n_rows > 0 && !out)) return -1;
+
+    for (int i = 0; i < n_rows; i++) {
+        int row = first_row + i;
+        if (PQgetisnull(res, row, col)) {
+            out[i] = 0;
+            continue;
+        }
+
+        long long v;
+        if (!field_integer(src, PQgetvalue(res, row, col), PQgetlength(res, row, col), &v) || v < INT32_MIN ||
+            v > INT32_MAX) {
+            return -1;
+        }
+        out[i] = (int32_t)v;
+        validity_set(validity, i);
+    }
+
+    return n_rows;
+}
+
+int pg_get_column_int64(const PGresult* res, int col, int first_row, int n_rows, int64_t* out, uint8_t* validity) {
+    field_source_t src;
+    n_rows = column_begin(res, col, first_row, n_rows, PG_FIELD_INT64, &src, validity);
+    if (n_rows < 0 || (n_rows > 0 && !out)) return -1;
+
+    for (int i = 0; i < n_rows; i++) {
+        int row = first_row + i;
+        if (PQgetisnull(res, row, col)) {
+            out[i] = 0;
+            continue;
+        }
+
+        long long v;
+        if (!field_integer(src, PQgetvalue(res, row, col), PQgetlength(res, row, col), &v)) return -1;
+        out[i] = (int64_t)v;
+        validity_set(validity, i);
+    }
+
+    return n_rows;
+}
+
+int pg_get_column_float4(const PGresult* res, int col, int first_row, int n_rows, float* out, uint8_t* validity) {
+    field_source_t src;
+    n_rows = column_begin(res, col, first_row, n_rows, PG_FIELD_FLOAT, &src, validity);
+    if (n_rows < 0 || (n_rows > 0 && !out)) return -1;
+
+    for (int i = 0; i < n_rows; i++) {
+        int row = first_row + i;
+        if (PQgetisnull(res, row, col)) {
+            out[i] = 0.0f;
+            continue;
+        }
+
+        double v;
+        if (!field_double(src, PQgetvalue(res, row, col), PQgetlength(res, row, col), &v)) return -1;
+        out[i] = (float)v;
+        validity_set(validity, i);
+    }
+
+    return n_rows;
+}
+
+int pg_get_column_float8(const PGresult* res, int col, int first_row, int n_rows, double* out, uint8_t* validity) {
+    field_source_t src;
+    n_rows = column_begin(res, col, first_row, n_rows, PG_FIELD_DOUBLE, &src, validity);
+    if (n_rows < 0 || (n_rows > 0 && !out)) return -1;
+
+    for (int i = 0; i < n_rows; i++) {
+        int row = first_row + i;
+        if (PQgetisnull(res, row, col)) {
+            out[i] = 0.0;
+            continue;
+        }
+
+        if (!field_double(src, PQgetvalue(res, row, col), PQgetlength(res, row, col), &out[i])) return -1;
+        validity_set(validity, i);
+    }
+
+    return n_rows;
+}
+
+int pg_get_column_bool(const PGresult* res, int col, int first_row, int n_rows, bool* out, uint8_t* validity) {
+    field_source_t src;
+    n_rows = column_begin(res, col, first_row, n_rows, PG_FIELD_BOOL, &src, validity);
+    if (n_rows < 0 || (n_rows > 0 && !out)) return -1;
+
+    for (int i = 0; i < n_rows; i++) {
+        int row = first_row + i;
+        if (PQgetisnull(res, row, col)) {
+            out[i] = false;
+            continue;
+        }
+
+        const char* val = PQgetvalue(res, row, col);
+        if (src == SRC_BOOL) {
+            if (PQgetlength(res, row, col) != 1) return -1;
+            out[i] = val[0] != 0;
+        } else if (!field_bool_text(val, PQgetlength(res, row, col), &out[i])) {
+            return -1;
+        }
+        validity_set(validity, i);
+    }
+
+    return n_rows;
+}
+
+// === Parameter Builder ===
+
+// Offset marker for SQL NULL parameters
+#define PARAM_NULL ((size_t)-1)
+
+struct pgconn_params {
+    char* data;           // Contiguous encoded values
+    size_t data_len;      // Bytes used in data
+    size_t data_cap;      // Capacity of data
+    size_t* offsets;      // Start of each value in data (PARAM_NULL for NULL)
+    const char** values;  // Pointers rebuilt from offsets by pgconn_params_values()
+    Oid* types;           // Type OID per parameter
+    int* lengths;         // Length per parameter
+    int* formats;         // Format per parameter (0 = text, 1 = binary)
+    int count;            // Number of parameters
+    int cap;              // Capacity of the per-parameter arrays
+};
+
+/** Writes a big-endian 32-bit value. */
+static inline void write_be32(char* p, uint32_t v) {
+#if __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+    v = __builtin_bswap32(v);
+#endif
+    memcpy(p, &v, sizeof(v));
+}
+
+/** Writes a big-endian 64-bit value. */
+static inline void write_be64(char* p, uint64_t v) {
+#if __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+    v = __builtin_bswap64(v);
+#endif
+    memcpy(p, &v, sizeof(v));
+}
+
+/**
+ * Reserves room for one more parameter of `len` bytes.
+ * Returns a pointer to the value storage, or NULL on allocation failure.
+ */
+static char* params_append(pgconn_params_t* p, Oid type, int format, size_t len) {
+    if (p->count == p->cap) {
+        int cap = p->cap ? p->cap * 2 : 8;
+
+        size_t* offsets = realloc(p->offsets, (size_t)cap * sizeof(*offsets));
+        if (offsets) p->offsets = offsets;
+        const char** values = realloc(p->values, (size_t)cap * sizeof(*values));
+        if (values) p->values = values;
+        Oid* types = realloc(p->types, (size_t)cap * sizeof(*types));
+        if (types) p->types = types;
+        int* lengths = realloc(p->lengths, (size_t)cap * sizeof(*lengths));
+        if (lengths) p->lengths = lengths;
+        int* formats = realloc(p->formats, (size_t)cap * sizeof(*formats));
+        if (formats) p->formats = formats;
+
+        if (!offsets || !values || !types || !lengths || !formats) {
+            return NULL;
+        }
+        p->cap = cap;
+    }
+
+    // Allocate even for an empty first value: libpq reads a NULL value pointer as SQL NULL
+    if (!p->data || p->data_len + len > p->data_cap) {
+        size_t cap = p->data_cap ? p->data_cap : 256;
+        while (cap < p->data_len + len) {
+            cap *= 2;
+        }
+
+        char* data = realloc(p->data, cap);
+        if (!data) {
+            return NULL;
+        }
+        p->data     = data;
+        p->data_cap = cap;
+    }
+
+    int i         = p->count++;
+    p->offsets[i] = p->data_len;
+    p->types[i]   = type;
+    p->lengths[i] = (int)len;
+    p->formats[i] = format;
+
+    char* value = p->data + p->data_len;
+    p->data_len += len;
+    return value;
+}
+
+pgconn_params_t* pgconn_params_create(void) {
+    return calloc(1, sizeof(pgconn_params_t));
+}
+
+void pgconn_params_destroy(pgconn_params_t* params) {
+    if (!params) return;
+
+    free(params->data);
+    free(params->offsets);
+    free(params->values);
+    free(params->types);
+    free(params->lengths);
+    free(params->formats);
+    free(params);
+}
+
+void pgconn_params_reset(pgconn_params_t* params) {
+    if (params) {
+        params->count    = 0;
+        params->data_len = 0;
+    }
+}
+
+bool pgconn_params_add_null(pgconn_params_t* params, Oid type) {
+    if (!params || !params_append(params, type, 1, 0)) return false;
+
+    params->offsets[params->count - 1] = PARAM_NULL;
+    return true;
+}
+
+bool pgconn_params_add_int4(pgconn_params_t* params, int32_t value) {
+    char* p = params ? params_append(params, PG_OID_INT4, 1, 4) : NULL;
+    if (!p) return false;
+
+    write_be32(p, (uint32_t)value);
+    return true;
+}
+
+bool pgconn_params_add_int8(pgconn_params_t* params, int64_t value) {
+    char* p = params ? params_append(params, PG_OID_INT8, 1, 8) : NULL;
+    if (!p) return false;
+
+    write_be64(p, (uint64_t)value);
+    return true;
+}
+
+bool pgconn_params_add_float8(pgconn_params_t* params, double value) {
+    char* p = params ? params_append(params, PG_OID_FLOAT8, 1, 8) : NULL;
+    if (!p) return false;
+
+    uint64_t bits;
+    memcpy(&bits, &value, sizeof(bits));
+    write_be64(p, bits);
+    return true;
+}
+
+bool pgconn_params_add_bool(pgconn_params_t* params, bool value) {
+    char* p = params ? params_append(params, PG_OID_BOOL, 1, 1) : NULL;
+    if (!p) return false;
+
+    *p = value ? 1 : 0;
+    return true;
+}
+
+bool pgconn_params_add_bytea(pgconn_params_t* params, const void* data, size_t len) {
+    if (!params || (!data && len > 0) || len > INT_MAX) return false;
+
+    char* p = params_append(params, PG_OID_BYTEA, 1, len);
+    if (!p) return false;
+
+    if (len > 0) memcpy(p, data, len);
+    return true;
+}
+
+bool pgconn_params_add_uuid(pgconn_params_t* params, const unsigned char bytes[16]) {
+    char* p = (params && bytes) ? params_append(params, PG_OID_UUID, 1, 16) : NULL;
+    if (!p) return false;
+
+    memcpy(p, bytes, 16);
+    return true;
+}
+
+bool pgconn_params_add_timestamptz(pgconn_params_t* params, struct timespec ts) {
+    char* p = params ? params_append(params, PG_OID_TIMESTAMPTZ, 1, 8) : NULL;
+    if (!p) return false;
+
+    int64_t micros = ((int64_t)ts.tv_sec - PG_EPOCH_UNIX) * 1000000 + ts.tv_nsec / 1000;
+    write_be64(p, (uint64_t)micros);
+    return true;
+}
+
+bool pgconn_params_add_text(pgconn_params_t* params, const char* value) {
+    if (!value) {
+        return pgconn_params_add_null(params, 0);
+    }
+
+    size_t len = strlen(value);
+    if (!params || len >= INT_MAX) return false;
+
+    // Keep the terminator so the value is also a valid C string
+    char* p = params_append(params, 0, 0, len + 1);
+    if (!p) return false;
+
+    memcpy(p, value, len + 1);
+    params->lengths[params->count - 1] = (int)len;
+    return true;
+}
+
+int pgconn_params_count(const pgconn_params_t* params) {
+    return params ? params->count : 0;
+}
+
+const Oid* pgconn_params_types(const pgconn_params_t* params) {
+    return params ? params->types : NULL;
+}
+
+const char* const* pgconn_params_values(pgconn_params_t* params) {
+    if (!params) return NULL;
+
+    // The data buffer may have moved since values were added, so pointers are
+    // derived from offsets only when they are handed out.
+    for (int i = 0; i < params->count; i++) {
+        size_t offset     = params->offsets[i];
+        params->values[i] = (offset == PARAM_NULL) ? NULL : params->data + offset;
+    }
+
+    return params->values;
+}
+
+const int* pgconn_params_lengths(const pgconn_params_t* params) {
+    return params ? params->lengths : NULL;
+}
+
+const int* pgconn_params_formats(const pgconn_params_t* params) {
+    return params ? params->formats : NULL;
+}
@@ -4,6 +4,8 @@
 #include <libpq-fe.h>
 #include <limits.h>
 #include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
 #include <stdlib.h>
 #include <string.h>
 #include <time.h>
@@ -12,6 +14,31 @@
 extern "C" {
 #endif
 
+// Built-in type OIDs (from the server's pg_type.h, which libpq does not ship)
+#define PG_OID_BOOL        16
+#define PG_OID_BYTEA       17
+#define PG_OID_INT8        20
+#define PG_OID_INT2        21
+#define PG_OID_INT4        23
+#define PG_OID_TEXT        25
+#define PG_OID_OID         26
+#define PG_OID_FLOAT4      700
+#define PG_OID_FLOAT8      701
+#define PG_OID_TIMESTAMP   1114
+#define PG_OID_TIMESTAMPTZ 1184
+#define PG_OID_UUID        2950
+
+// Unix time of the PostgreSQL epoch (2000-01-01 00:00:00 UTC)
+#define PG_EPOCH_UNIX 946684800LL
+
+/*
+ * Every numeric, boolean and timestamp getter below accepts both text and binary
+ * columns. Binary columns (result_format = 1) are decoded from network byte order
+ * according to PQftype() without any string parsing. Integer columns (int2, int4,
+ * int8, oid) can be read with any integer or floating-point getter as long as the
+ * value fits; float getters also accept float4 and float8.
+ */
+
 /**
  * @brief Retrieve an integer value from a PGresult.
  *
@@ -127,10 +154,23 @@ const unsigned char* pg_get_binary(PGresult* res, int row, int col, size_t* leng
  * @param row   Row index in the result set.
  * @param col   Column index in the result set.
  * @param valid Optional pointer to a bool that will be set to true if the value is valid and not NULL.
- * @return      Pointer to the UUID string (36 characters). NULL on error or invalid format.
+ * @return      Pointer to the UUID string (36 characters). NULL on error, invalid format or
+ *              binary columns (use pg_get_uuid_bytes() for those).
  */
 const char* pg_get_uuid(PGresult* res, int row, int col, bool* valid);
 
+/**
+ * @brief Retrieve a UUID value as 16 raw bytes from a text or binary column.
+ *
+ * @param res   Pointer to the PGresult structure.
+ * @param row   Row index in the result set.
+ * @param col   Column index in the result set.
+ * @param out   Buffer receiving the 16 UUID bytes in network order.
+ * @param valid Optional pointer to a bool that will be set to true if the value is valid and not NULL.
+ * @return      true on success, false on NULL or invalid value.
+ */
+bool pg_get_uuid_bytes(PGresult* res, int row, int col, unsigned char out[16], bool* valid);
+
 /**
  * @brief Retrieve a timestamp value from a PGresult and convert it to a struct timespec.
  *
@@ -144,6 +184,241 @@ const char* pg_get_uuid(PGresult* res, int row, int col, bool* valid);
  */
 struct timespec pg_get_timestamp(PGresult* res, int row, int col, bool* valid);
 
+// === Row Mapper ===
+
+/**
+ * C type of a struct member filled by pg_binding_fill().
+ *
+ * Numeric, boolean, UUID and timestamp members accept the same column types as
+ * the matching pg_get_* getter, in text or binary format.
+ */
+typedef enum {
+    PG_FIELD_INT32,      // int32_t
+    PG_FIELD_INT64,      // int64_t
+    PG_FIELD_FLOAT,      // float
+    PG_FIELD_DOUBLE,     // double
+    PG_FIELD_BOOL,       // bool
+    PG_FIELD_STRING,     // const char*, pointing into the result (valid until PQclear)
+    PG_FIELD_STRBUF,     // char[N], copied and truncated to N - 1 bytes
+    PG_FIELD_UUID,       // unsigned char[16] (see pg_get_uuid_bytes())
+    PG_FIELD_TIMESTAMP,  // struct timespec (see pg_get_timestamp())
+} pg_field_type_t;
+
+/**
+ * Describes how one result column maps to a struct member. Build entries with
+ * PG_FIELD() and PG_FIELD_NULLABLE().
+ */
+typedef struct {
+    const char* column;      // Column name, matched like PQfnumber()
+    pg_field_type_t type;    // Member type
+    size_t offset;           // offsetof() the member
+    size_t size;             // sizeof() the member
+    bool nullable;           // Record SQL NULL in a bool member
+    size_t null_offset;      // offsetof() that bool member (if nullable)
+} pg_field_t;
+
+/** Maps column `column` to `member` of `struct_type`. SQL NULL leaves the member zeroed. */
+#define PG_FIELD(struct_type, member, field_type, column)                                                   \
+    {(column), (field_type), offsetof(struct_type, member), sizeof(((struct_type*)0)->member), false, 0}
+
+/** Like PG_FIELD(), and also sets the bool `null_member` to whether the value was SQL NULL. */
+#define PG_FIELD_NULLABLE(struct_type, member, field_type, column, null_member)                             \
+    {(column), (field_type), offsetof(struct_type, member), sizeof(((struct_type*)0)->member), true,        \
+     offsetof(struct_type, null_member)}
+
+/**
+ * Column numbers and decoders of a row mapping, resolved once per result shape.
+ *
+ * @code
+ * typedef struct {
+ *     int64_t id;
+ *     char name[64];
+ *     double balance;
+ *     bool balance_null;
+ * } account_t;
+ *
+ * static const pg_field_t account_fields[] = {
+ *     PG_FIELD(account_t, id, PG_FIELD_INT64, "id"),
+ *     PG_FIELD(account_t, name, PG_FIELD_STRBUF, "name"),
+ *     PG_FIELD_NULLABLE(account_t, balance, PG_FIELD_DOUBLE, "balance", balance_null),
+ * };
+ *
+ * pg_binding_t* b = pg_bind(res, account_fields, sizeof(account_fields) / sizeof(account_fields[0]));
+ * account_t* rows = malloc((size_t)PQntuples(res) * sizeof(account_t));
+ * int n = pg_binding_fill(b, res, 0, PQntuples(res), rows, sizeof(account_t));
+ * pg_binding_free(b);
+ * @endcode
+ */
+typedef struct pg_binding pg_binding_t;
+
+/**
+ * @brief Resolve a row mapping against a result.
+ *
+ * Looks up every column by name and picks its decoder from the column's
+ * format and type, so pg_binding_fill() does no per-cell lookups.
+ *
+ * @param res      Result whose columns are bound.
+ * @param fields   Member descriptions (not copied; column names may be freed afterwards).
+ * @param n_fields Number of entries in fields.
+ * @return New binding, or NULL if a column is missing, a binary column's type
+ *         cannot be stored in its member, a member size does not match its
+ *         type, or allocation fails. Free with pg_binding_free().
+ */
+pg_binding_t* pg_bind(const PGresult* res, const pg_field_t* fields, size_t n_fields);
+
+/**
+ * @brief Free a binding. Safe to call with NULL.
+ */
+void pg_binding_free(pg_binding_t* binding);
+
+/**
+ * @brief Fill an array of structs from consecutive result rows.
+ *
+ * The binding can be reused for any result with the same columns, such as every
+ * result returned by pgconn_stream_next().
+ *
+ * @param binding   Binding from pg_bind().
+ * @param res       Result to read.
+ * @param first_row First row to read.
+ * @param n_rows    Number of rows to read (clamped to the rows available).
+ * @param out       First struct to fill.
+ * @param stride    Distance between structs in bytes, normally sizeof(struct).
+ * @return Number of rows filled, or -1 if the result has a different number
+ *         of columns or a value cannot be converted (out of range, bad text or
+ *         bad binary length). Rows before the bad one are filled.
+ */
+int pg_binding_fill(const pg_binding_t* binding, const PGresult* res, int first_row, int n_rows, void* out,
+                    size_t stride);
+
+// === Column Extraction ===
+
+/*
+ * The pg_get_column_* functions decode rows [first_row, first_row + n_rows) of
+ * one column into a contiguous array, clamping n_rows to the rows available.
+ * The column's format and type are checked once, not per cell, and accept the
+ * same types as the matching pg_get_* getter.
+ *
+ * validity is an optional bitmap of (n_rows + 7) / 8 bytes in Apache Arrow
+ * layout: bit i (LSB first) is set when row first_row + i is not NULL. NULL
+ * values are stored as zero. Each function returns the number of rows
+ * decoded, or -1 if the column does not exist, its binary type does not fit,
+ * or a value cannot be converted (earlier rows are still written).
+ */
+
+/** @brief Decode an integer column into int32_t values. */
+int pg_get_column_int32(const PGresult* res, int col, int first_row, int n_rows, int32_t* out, uint8_t* validity);
+
+/** @brief Decode an integer column into int64_t values. */
+int pg_get_column_int64(const PGresult* res, int col, int first_row, int n_rows, int64_t* out, uint8_t* validity);
+
+/** @brief Decode a floating-point or integer column into float values. */
+int pg_get_column_float4(const PGresult* res, int col, int first_row, int n_rows, float* out, uint8_t* validity);
+
+/** @brief Decode a floating-point or integer column into double values. */
+int pg_get_column_float8(const PGresult* res, int col, int first_row, int n_rows, double* out, uint8_t* validity);
+
+/** @brief Decode a boolean column into bool values. */
+int pg_get_column_bool(const PGresult* res, int col, int first_row, int n_rows, bool* out, uint8_t* validity);
+
+// === Parameter Builder ===
+
+/**
+ * Accumulates query parameters in binary send format.
+ *
+ * Values are encoded into one contiguous buffer, and the four arrays expected by
+ * pgconn_query_params_full(), pgconn_execute_prepared_full() and PQexecParams()
+ * are produced from it without formatting numbers as text. Reuse one builder
+ * across queries with pgconn_params_reset() to avoid reallocations.
+ *
+ * @code
+ * pgconn_params_t* p = pgconn_params_create();
+ * pgconn_params_add_int8(p, user_id);
+ * pgconn_params_add_text(p, name);
+ * PGresult* res = pgconn_query_params_full(conn, "SELECT ... WHERE id = $1 AND name = $2",
+ *                                          pgconn_params_count(p), pgconn_params_types(p),
+ *                                          pgconn_params_values(p), pgconn_params_lengths(p),
+ *                                          pgconn_params_formats(p), 1, NULL);
+ * pgconn_params_destroy(p);
+ * @endcode
+ */
+typedef struct pgconn_params pgconn_params_t;
+
+/**
+ * @brief Create an empty parameter builder.
+ * @return New builder, or NULL on allocation failure. Free with pgconn_params_destroy().
+ */
+pgconn_params_t* pgconn_params_create(void);
+
+/**
+ * @brief Free a parameter builder. Safe to call with NULL.
+ */
+void pgconn_params_destroy(pgconn_params_t* params);
+
+/**
+ * @brief Remove all parameters, keeping the allocated memory for reuse.
+ */
+void pgconn_params_reset(pgconn_params_t* params);
+
+/**
+ * @brief Append a SQL NULL of the given type (0 lets the server infer it).
+ * @return true on success, false on allocation failure.
+ */
+bool pgconn_params_add_null(pgconn_params_t* params, Oid type);
+
+/** @brief Append an int4 value. @return true on success, false on allocation failure. */
+bool pgconn_params_add_int4(pgconn_params_t* params, int32_t value);
+
+/** @brief Append an int8 value. @return true on success, false on allocation failure. */
+bool pgconn_params_add_int8(pgconn_params_t* params, int64_t value);
+
+/** @brief Append a float8 value. @return true on success, false on allocation failure. */
+bool pgconn_params_add_float8(pgconn_params_t* params, double value);
+
+/** @brief Append a boolean value. @return true on success, false on allocation failure. */
+bool pgconn_params_add_bool(pgconn_params_t* params, bool value);
+
+/**
+ * @brief Append a bytea value. The data is copied.
+ * @return true on success, false on allocation failure or if data is NULL with len > 0.
+ */
+bool pgconn_params_add_bytea(pgconn_params_t* params, const void* data, size_t len);
+
+/**
+ * @brief Append a UUID given as 16 raw bytes (see pg_get_uuid_bytes()).
+ * @return true on success, false on allocation failure.
+ */
+bool pgconn_params_add_uuid(pgconn_params_t* params, const unsigned char bytes[16]);
+
+/**
+ * @brief Append a timestamptz value given as Unix time (see pg_get_timestamp()).
+ * @return true on success, false on allocation failure.
+ */
+bool pgconn_params_add_timestamptz(pgconn_params_t* params, struct timespec ts);
+
+/**
+ * @brief Append a text value. The string is copied; NULL appends SQL NULL.
+ *
+ * The type is left unspecified so the server infers it from context, as with
+ * plain text parameters.
+ * @return true on success, false on allocation failure.
+ */
+bool pgconn_params_add_text(pgconn_params_t* params, const char* value);
+
+/** @brief Number of parameters added so far. */
+int pgconn_params_count(const pgconn_params_t* params);
+
+/** @brief Parameter type OIDs. Valid until the next add, reset or destroy. */
+const Oid* pgconn_params_types(const pgconn_params_t* params);
+
+/** @brief Parameter value pointers (NULL for SQL NULL). Valid until the next add, reset or destroy. */
+const char* const* pgconn_params_values(pgconn_params_t* params);
+
+/** @brief Parameter lengths in bytes. Valid until the next add, reset or destroy. */
+const int* pgconn_params_lengths(const pgconn_params_t* params);
+
+/** @brief Parameter formats (0 = text, 1 = binary). Valid until the next add, reset or destroy. */
+const int* pgconn_params_formats(const pgconn_params_t* params);
+
 #ifdef __cplusplus
 }
 #endif